@@ -0,0 +1,112 @@
+#include "src/NodesDistance.h"
+#include "src/InstanceParser.h"
+#include "src/SpatioTemporal.h"
+#include "src/GeneticEvolution.h"
+#include "src/KMedoid.h"
+#include "src/DistancePolicy.h"
+#include <iostream>
+#include <chrono>
+#include <string>
+#include <vector>
+
+const std::string input_folder = "input/";
+
+/*
+* compares the precisions of the distance matrices: memory, time needed to compute them, partition time and
+* cost of the partition. Costs are always measured with the double spatiotemporal distance, so the difference
+* shows how much the rounding changes the partition
+*/
+
+//sum of the distances between every customer and the other members of its group
+double partition_cost(SpatioTemporal& reference, std::vector<std::vector<int>>& partition)
+{
+	double cost = 0;
+	for (auto& group : partition)
+	{
+		for (auto customer : group)
+		{
+			cost += group_distance(reference, customer, group);
+		}
+	}
+	return cost / 2.0;
+}
+
+std::string precision_name(matrix_precision precision)
+{
+	switch (precision)
+	{
+	case matrix_precision::f32:
+		return "f32";
+	case matrix_precision::u16:
+		return "u16";
+	default:
+		return "f64";
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	std::string input_name;
+	int groups;
+
+	if (argc >= 3)
+	{
+		input_name = argv[1];
+		groups = std::stoi(argv[2]);
+	}
+	else
+	{
+		std::cout << "Insert input file name ( as name.extension ): ";
+		std::cin >> input_name;
+		std::cout << "insert number of desired clusters: ";
+		std::cin >> groups;
+	}
+
+	nodes node;
+	parse_error error;
+	if (!parse_nodes(node, input_folder + input_name, error))
+	{
+		std::cout << "file can not be read, line " << error.line << ": " << error.message << std::endl;
+		return 1;
+	}
+
+	SpatioTemporal reference(node);
+	double reference_cost[2] = { 0.0, 0.0 };
+
+	for (auto precision : { matrix_precision::f64, matrix_precision::f32, matrix_precision::u16 })
+	{
+		auto clock_start = std::chrono::steady_clock::now();
+		SpatioTemporal distance(node, matrix_layout::full, precision);
+		auto clock_end = std::chrono::steady_clock::now();
+		auto build_time = std::chrono::duration_cast<std::chrono::milliseconds>(clock_end - clock_start).count();
+
+		clock_start = std::chrono::steady_clock::now();
+		GeneticEvolution genetic(distance);
+		auto genetic_partition = genetic.genetic_part(groups);
+		clock_end = std::chrono::steady_clock::now();
+		auto genetic_time = std::chrono::duration_cast<std::chrono::milliseconds>(clock_end - clock_start).count();
+
+		clock_start = std::chrono::steady_clock::now();
+		KMedoid medoid(distance);
+		auto medoid_partition = medoid.medoid_part(groups);
+		clock_end = std::chrono::steady_clock::now();
+		auto medoid_time = std::chrono::duration_cast<std::chrono::milliseconds>(clock_end - clock_start).count();
+
+		double cost[2] = { partition_cost(reference, genetic_partition), partition_cost(reference, medoid_partition) };
+		if (precision == matrix_precision::f64)
+		{
+			reference_cost[0] = cost[0];
+			reference_cost[1] = cost[1];
+		}
+
+		std::cout << precision_name(precision) << ":" << std::endl <<
+			"    matrices memory: " << distance.get_memory() / 1024 << " KiB    build time: " << build_time << " ms" << std::endl <<
+			"    genetic partition: " << genetic_time << " ms    cost: " << cost[0] <<
+			"    difference from f64: " << 100.0 * (cost[0] - reference_cost[0]) / reference_cost[0] << "%" << std::endl <<
+			"    k-medoid partition: " << medoid_time << " ms    cost: " << cost[1] <<
+			"    difference from f64: " << 100.0 * (cost[1] - reference_cost[1]) / reference_cost[1] << "%" << std::endl;
+	}
+
+	//partitioners draw random numbers, the differences include the ones due to different random choices
+	return 0;
+}
@@ -0,0 +1,214 @@
+#include "src/DistanceKernels.h"
+#include "src/CpuFeatures.h"
+#include <iostream>
+#include <random>
+#include <vector>
+#include <cmath>
+#include <cstring>
+
+/*
+* checks the vectorized kernels of DistanceKernels.h against the scalar ones. Every kernel is run at every instruction set
+* supported by the cpu and must give exactly the values of the scalar implementation, which in turn must give the values
+* of the plain loops below (the same expressions used by Spatial, Spatial3d and SpatioTemporal).
+* Rows have every length up to a few vector widths, so the scalar tails are exercised, and values are small integers, so
+* there are many ties. Exits with 1 if any value differs
+*/
+
+//customers of the random instances, coordinates and time windows as in Solomon's instances
+const int customers = 80;
+
+//random instance stored as structure of arrays
+struct columns
+{
+	std::vector<double> x, y, z;
+	std::vector<double> ready, due, service;
+};
+
+columns random_columns(std::default_random_engine& engine)
+{
+	std::uniform_int_distribution<int> coord(0, 100), start(0, 1000), width(1, 300), service(0, 90);
+	columns data;
+
+	for (auto i = 0; i < customers; i++)
+	{
+		data.x.push_back(coord(engine));
+		data.y.push_back(coord(engine));
+		data.z.push_back(coord(engine));
+		data.ready.push_back(start(engine));
+		data.due.push_back(data.ready.back() + width(engine));
+		data.service.push_back(service(engine));
+	}
+
+	return data;
+}
+
+//equal values, NaN equal to NaN
+bool same(double a, double b)
+{
+	return std::memcmp(&a, &b, sizeof(double)) == 0 || (std::isnan(a) && std::isnan(b));
+}
+
+//counter of the values checked and of the differences for a kernel at an instruction set
+struct check
+{
+	long long values = 0;
+	long long errors = 0;
+
+	void compare(double found, double expected)
+	{
+		this->values++;
+		if (!same(found, expected))
+			this->errors++;
+	}
+};
+
+void test_euclidean(const columns& data, check& result)
+{
+	std::vector<double> distance(customers);
+	std::vector<int> time(customers);
+
+	for (auto from = 0; from < customers; from++)
+	{
+		for (auto begin = 0; begin < customers; begin += 7)
+		{
+			for (auto end = begin; end <= std::min(begin + 40, customers); end++)
+			{
+				euclidean_row(data.x.data(), data.y.data(), from, begin, end, distance.data(), time.data());
+
+				//plain loop, as Spatial and OrTools compute a single distance
+				for (auto j = begin; j < end; j++)
+				{
+					auto squared = std::pow(data.x[from] - data.x[j], 2) + std::pow(data.y[from] - data.y[j], 2);
+					result.compare(distance[j - begin], std::sqrt(squared));
+					result.compare(time[j - begin], int(std::sqrt(squared + 0.5)));
+				}
+			}
+		}
+	}
+}
+
+void test_euclidean3d(const columns& data, check& result)
+{
+	std::vector<double> distance(customers);
+
+	for (auto from = 0; from < customers; from++)
+	{
+		for (auto begin = 0; begin < customers; begin += 7)
+		{
+			for (auto end = begin; end <= std::min(begin + 40, customers); end++)
+			{
+				euclidean3d_row(data.x.data(), data.y.data(), data.z.data(), from, begin, end, distance.data());
+
+				for (auto j = begin; j < end; j++)
+				{
+					auto dx = data.x[from] - data.x[j], dy = data.y[from] - data.y[j], dz = data.z[from] - data.z[j];
+					result.compare(distance[j - begin], std::sqrt(dx * dx + dy * dy + dz * dz));
+				}
+			}
+		}
+	}
+}
+
+void test_temporal(const columns& data, check& result)
+{
+	temporal_parameters parameters = { 1.0, 1.5, 2.0, 300.0 };
+	std::vector<double> travel(customers), distance(customers);
+
+	for (auto from = 0; from < customers; from++)
+	{
+		for (auto begin = 0; begin < customers; begin += 7)
+		{
+			for (auto end = begin; end <= std::min(begin + 40, customers); end++)
+			{
+				euclidean_row(data.x.data(), data.y.data(), from, begin, end, travel.data(), nullptr);
+				temporal_row(data.ready.data(), data.due.data(), data.service.data(), travel.data(), from, begin, end, parameters, distance.data());
+
+				//temporal_pair always uses the scalar implementation
+				for (auto j = begin; j < end; j++)
+				{
+					auto expected = temporal_pair(data.ready.data(), data.due.data(), data.service.data(), travel[j - begin], from, j, parameters);
+					result.compare(distance[j - begin], expected);
+				}
+			}
+		}
+	}
+}
+
+void test_nearest(std::default_random_engine& engine, check& result)
+{
+	//few different values, so many columns have ties between rows
+	std::uniform_int_distribution<int> value(0, 9);
+
+	for (auto k = 1; k <= 20; k++)
+	{
+		for (auto count = 0; count <= 40; count++)
+		{
+			auto stride = std::size_t(count) + k % 3;
+			std::vector<double> rows(std::size_t(k) * stride + 1);
+			for (auto& row_value : rows)
+				row_value = value(engine);
+
+			std::vector<double> nearest(count);
+			std::vector<int> label(count);
+			auto total = nearest_rows(rows.data(), k, stride, count, nearest.data(), label.data(), 0.5);
+			auto total_only = nearest_rows(rows.data(), k, stride, count, nullptr, nullptr, 0.5);
+
+			//first row with the minimum value, values added in order of column
+			auto expected_total = 0.5;
+			for (auto i = 0; i < count; i++)
+			{
+				auto min = rows[i];
+				auto position = 0;
+				for (auto j = 1; j < k; j++)
+				{
+					if (rows[j * stride + i] < min)
+					{
+						min = rows[j * stride + i];
+						position = j;
+					}
+				}
+
+				result.compare(nearest[i], min);
+				result.compare(label[i], position);
+				expected_total += min;
+			}
+			result.compare(total, expected_total);
+			result.compare(total_only, expected_total);
+		}
+	}
+}
+
+int main()
+{
+	std::default_random_engine engine(7);
+	auto data = random_columns(engine);
+	bool failed = false;
+
+	for (auto level : { simd_level::scalar, simd_level::avx2, simd_level::avx512 })
+	{
+		force_simd_level(level);
+		if (active_simd_level() != level)
+		{
+			std::cout << simd_level_name(level) << ": not supported by the cpu" << std::endl;
+			continue;
+		}
+
+		check euclidean, euclidean3d, temporal, nearest;
+		test_euclidean(data, euclidean);
+		test_euclidean3d(data, euclidean3d);
+		test_temporal(data, temporal);
+		test_nearest(engine, nearest);
+
+		std::pair<const char*, check*> kernels[] = { { "euclidean_row", &euclidean }, { "euclidean3d_row", &euclidean3d },
+			{ "temporal_row", &temporal }, { "nearest_rows", &nearest } };
+		for (auto& kernel : kernels)
+		{
+			std::cout << simd_level_name(level) << " " << kernel.first << ": " << kernel.second->values << " values, " <<
+				kernel.second->errors << " differences" << std::endl;
+			failed = failed || kernel.second->errors > 0;
+		}
+	}
+
+	std::cout << (failed ? "FAILED" : "OK") << std::endl;
+	return failed ? 1 : 0;
+}
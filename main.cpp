@@ -1,32 +1,53 @@
 #include "src/NodesDistance.h"
+#include "src/Instance.h"
+#include "src/InstanceParser.h"
 #include "src/Spatial.h"
 #include "src/SpatioTemporal.h"
 #include "src/GeneticEvolution.h"
 #include "src/Voronoi.h"
 #include "src/OrTools.h"
 #include "src/KMedoid.h"
+#include "src/MatrixCache.h"
+#include "src/CurveOrder.h"
 #include <iostream>
+#include <memory>
 #include <chrono> 
 
 const std::string input_folder = "input/";
 const std::string output_folder = "output/";
+const std::string cache_folder = "cache/";
+
+//if true spatiotemporal matrices are stored in cache_folder and read back when the same instance is partitioned again
+const bool use_matrix_cache = false;
+
+//if true customers are renumbered along a Hilbert curve before partitioning, so near customers get near ids and
+//matrices and sub-matrices are read almost sequentially. Routes are given back with the ids of the file
+const bool use_curve_order = false;
+
+//spatiotemporal parameters k1, k2, k3, alpha1
+const double parameters[4] = { 1.0, 1.5, 2.0, 0.5 };
 
 int main()
 {
 	int option = -1;
 
+	//matrices computed by previous runs, at most 4 GiB
+	std::unique_ptr<MatrixCache> cache;
+	if (use_matrix_cache)
+		cache = std::make_unique<MatrixCache>(cache_folder, std::uint64_t(4) << 30);
+
 	while (option != 0)
 	{
 		nodes node;
 		std::cout << "Insert input file name ( as name.extension ): ";
 		std::string input_name;
 		std::cin >> input_name;
-		init_nodes(node, input_folder + input_name);
+		parse_error error;
 
-		if (node.id.size() <= 0)
+		if (!parse_nodes(node, input_folder + input_name, error))
 		{
 			option = -1;
-			std::cout << "file name is not correct" << std::endl;
+			std::cout << "file can not be read, line " << error.line << ": " << error.message << std::endl;
 		}
 
 		else
@@ -34,6 +55,13 @@ int main()
 			compact_solution solution;
 			bool found_solution = false;
 
+			CurveOrder order(node);
+			if (use_curve_order)
+				node = order.reorder(node);
+
+			//nodes and travel times shared by the distance, the partitioners and the solver, neither copied nor computed again
+			auto instance = std::make_shared<const Instance>(node);
+
 			std::cout << "insert:" << std::endl <<
 				"1: solve problem after partitioning in sub-problems" << std::endl <<
 				"2: directly solve problem" << std::endl;
@@ -43,6 +71,8 @@ int main()
 			{
 				int sub_option;
 				NodesDistance* distance = nullptr;
+				NodesSnapshot snapshot;
+
 				std::cout << "insert:" << std::endl <<
 					"1: use Euclidian distance" << std::endl <<
 					"2: use spatiotemporal distance" << std::endl;
@@ -51,10 +81,25 @@ int main()
 				switch (sub_option)
 				{
 				case 1:
-					distance = new Spatial(node);
+					distance = new Spatial(instance);
 					break;
 				case 2:
-					distance = new SpatioTemporal(node);
+					//the matrices are read from the cache when the same instance has already been partitioned
+					if (cache != nullptr && cache->open(node, parameters[0], parameters[1], parameters[2], parameters[3], snapshot))
+					{
+						distance = new SpatioTemporal(snapshot, parameters[0], parameters[1], parameters[2], parameters[3]);
+					}
+					else
+					{
+						auto spatio_temporal = new SpatioTemporal(instance, parameters[0], parameters[1], parameters[2], parameters[3]);
+						if (cache != nullptr)
+						{
+							snapshot_matrices matrices;
+							spatio_temporal->add_to_snapshot(matrices);
+							cache->store(node, matrices);
+						}
+						distance = spatio_temporal;
+					}
 					break;
 				}
 
@@ -80,7 +125,7 @@ int main()
 				}
 				case 2:
 				{
-					Voronoi voro(node, *distance);
+					Voronoi voro(instance, *distance);
 					partition = voro.voronoi_part(cluster);
 					break;
 				}
@@ -92,7 +137,7 @@ int main()
 				}
 				}
 
-				OrTools solver(node);
+				OrTools solver(instance);
 
 				for (int i = 0; i < partition.size(); i++)
 				{
@@ -111,13 +156,17 @@ int main()
 
 			else if (option == 2)
 			{
-				OrTools solver(node);
+				OrTools solver(instance);
 				solution = solver.solve_problem();
 				found_solution = true;
 			}
 
 			if (found_solution)
 			{
+				//routes use the ids of the file
+				if (use_curve_order)
+					order.restore(solution.routes);
+
 				std::cout << "Insert output file name ( as name.extension ): ";
 				std::string output_name;
 				std::cin >> output_name;
@@ -0,0 +1,107 @@
+#include "src/NodesDistance.h"
+#include "src/InstanceParser.h"
+#include "src/Spatial.h"
+#include "src/KMedoid.h"
+#include "src/OrTools.h"
+#include "src/CompatibilityIndex.h"
+#include "src/TimeWindowTightening.h"
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <vector>
+
+const std::string input_folder = "input/";
+
+/*
+* compares OrTools with and without preprocessing (see OrTools::set_preprocessing) on the same partition:
+* time windows removed by the tightening, arcs removed from the model, solve time and cost of the solution.
+* Meant for the instances with tight time windows, e.g. C110_1.TXT and R110_1.TXT
+*/
+
+//travel times as OrTools
+std::vector<std::vector<int>> time_matrix(nodes& node)
+{
+	int size = node.id.size();
+	std::vector<std::vector<int>> times(size, std::vector<int>(size));
+	for (int i = 0; i < size; i++)
+	{
+		for (int j = 0; j < size; j++)
+		{
+			times[i][j] = int(std::sqrt(std::pow(node.coord[i][0] - node.coord[j][0], 2) + std::pow(node.coord[i][1] - node.coord[j][1], 2) + 0.5));
+		}
+	}
+	return times;
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc < 3)
+	{
+		std::cout << "usage: preprocessing_benchmark groups file1 [file2 ...]" << std::endl;
+		return 1;
+	}
+
+	int groups = std::stoi(argv[1]);
+
+	for (int file = 2; file < argc; file++)
+	{
+		nodes node;
+		parse_error error;
+		if (!parse_nodes(node, input_folder + argv[file], error))
+		{
+			std::cout << argv[file] << ": line " << error.line << ": " << error.message << std::endl;
+			continue;
+		}
+
+		//size of the preprocessing on the whole instance
+		auto times = time_matrix(node);
+		nodes tightened = node;
+		auto tightening = tighten_time_windows(tightened, times);
+		CompatibilityIndex compatibility(tightened, times);
+
+		long long arcs = 0, removed = 0;
+		for (int i = 1; i < node.id.size(); i++)
+		{
+			for (int j = 1; j < node.id.size(); j++)
+			{
+				if (i == j)
+					continue;
+				arcs++;
+				removed += !compatibility.compatible(i, j) || node.demand[i] + node.demand[j] > node.capacity;
+			}
+		}
+
+		std::cout << argv[file] << ":" << std::endl <<
+			"    tightened windows: " << tightening.tightened << " in " << tightening.rounds << " rounds, removed width " << tightening.removed_width << std::endl <<
+			"    removed arcs: " << 100.0 * removed / arcs << "%" << std::endl;
+
+		//the same partition is solved twice
+		Spatial distance(node);
+		KMedoid medoid(distance);
+		auto partition = medoid.medoid_part(groups);
+
+		for (auto preprocessing : { false, true })
+		{
+			OrTools solver(node);
+			solver.set_preprocessing(preprocessing);
+
+			double cost = 0;
+			int vehicles = 0;
+			auto clock_start = std::chrono::steady_clock::now();
+			for (auto& group : partition)
+			{
+				auto solution = solver.solve_sub_problem(group);
+				cost += solution.total_cost;
+				vehicles += solution.number_vehicles;
+			}
+			auto clock_end = std::chrono::steady_clock::now();
+
+			std::cout << (preprocessing ? "    with preprocessing: " : "    without preprocessing: ") <<
+				std::chrono::duration_cast<std::chrono::milliseconds>(clock_end - clock_start).count() << " ms    cost: " << cost <<
+				"    vehicles: " << vehicles << std::endl;
+		}
+	}
+
+	return 0;
+}
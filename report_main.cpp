@@ -1,6 +1,7 @@
 #include "src/NodesDistance.h"
 #include "src/Spatial.h"
 #include "src/Spatial3d.h"
+#include "src/Instance.h"
 #include <thread>
 #include <atomic>
 #include "src/SpatioTemporal.h"
@@ -25,11 +26,11 @@ void global(OrTools& solver, std::vector<int>& part, std::atomic<double>& cost,
 	vehicles += sol.number_vehicles;
 }
 
-int voronoi_solve_concurrent(nodes &node, NodesDistance& distance, int n_part, std::ofstream& output, bool balanced)
+int voronoi_solve_concurrent(std::shared_ptr<const Instance> instance, NodesDistance& distance, int n_part, std::ofstream& output, bool balanced)
 {
-	OrTools solver(node);
+	OrTools solver(instance);
 	auto clock_start = std::chrono::system_clock::now();
-	Voronoi voro(node, distance, balanced);
+	Voronoi voro(instance, distance, balanced);
 	auto part = voro.voronoi_part_bubble(n_part);
 	std::vector<std::thread> threads;
 	std::atomic<double> cost(0);
@@ -51,11 +52,11 @@ int voronoi_solve_concurrent(nodes &node, NodesDistance& distance, int n_part, s
 	return 0;
 }
 
-int voronoi_solve(nodes& node, NodesDistance& distance, int n_part, std::ofstream& output, bool balanced)
+int voronoi_solve(std::shared_ptr<const Instance> instance, NodesDistance& distance, int n_part, std::ofstream& output, bool balanced)
 {
-	OrTools solver(node);
+	OrTools solver(instance);
 	auto clock_start = std::chrono::system_clock::now();
-	Voronoi voro(node, distance, balanced);
+	Voronoi voro(instance, distance, balanced);
 	auto part = voro.voronoi_part_bubble(n_part);
 	double cost = 0;
 	double vehicles = 0;
@@ -73,9 +74,9 @@ int voronoi_solve(nodes& node, NodesDistance& distance, int n_part, std::ofstrea
 	return 0;
 }
 
-int genetic_solve(nodes& node, NodesDistance& distance, int n_part, std::ofstream& output)
+int genetic_solve(std::shared_ptr<const Instance> instance, NodesDistance& distance, int n_part, std::ofstream& output)
 {
-	OrTools solver(node);
+	OrTools solver(instance);
 	auto clock_start = std::chrono::system_clock::now();
 	GeneticEvolution genetic(distance);
 	auto part = genetic.genetic_part(n_part);
@@ -95,9 +96,9 @@ int genetic_solve(nodes& node, NodesDistance& distance, int n_part, std::ofstrea
 	return 0;
 }
 
-int genetic_solve_concurrent(nodes& node, NodesDistance& distance, int n_part, std::ofstream& output)
+int genetic_solve_concurrent(std::shared_ptr<const Instance> instance, NodesDistance& distance, int n_part, std::ofstream& output)
 {
-	OrTools solver(node);
+	OrTools solver(instance);
 	auto clock_start = std::chrono::system_clock::now();
 	GeneticEvolution genetic(distance);
 	auto part = genetic.genetic_part(n_part);
@@ -121,9 +122,9 @@ int genetic_solve_concurrent(nodes& node, NodesDistance& distance, int n_part, s
 	return 0;
 }
 
-int medoid_solve(nodes& node, NodesDistance& distance, int n_part, std::ofstream& output)
+int medoid_solve(std::shared_ptr<const Instance> instance, NodesDistance& distance, int n_part, std::ofstream& output)
 {
-	OrTools solver(node);
+	OrTools solver(instance);
 	auto clock_start = std::chrono::system_clock::now();
 	KMedoid medoid(distance);
 	auto part = medoid.medoid_part(n_part);
@@ -143,9 +144,9 @@ int medoid_solve(nodes& node, NodesDistance& distance, int n_part, std::ofstream
 	return 0;
 }
 
-int medoid_solve_concurrent(nodes& node, NodesDistance& distance, int n_part, std::ofstream& output)
+int medoid_solve_concurrent(std::shared_ptr<const Instance> instance, NodesDistance& distance, int n_part, std::ofstream& output)
 {
-	OrTools solver(node);
+	OrTools solver(instance);
 	auto clock_start = std::chrono::system_clock::now();
 	KMedoid medoid(distance);
 	auto part = medoid.medoid_part(n_part);
@@ -169,9 +170,9 @@ int medoid_solve_concurrent(nodes& node, NodesDistance& distance, int n_part, st
 	return 0;
 }
 
-void direct_solve(nodes& node, NodesDistance& distance, std::ofstream& output)
+void direct_solve(std::shared_ptr<const Instance> instance, NodesDistance& distance, std::ofstream& output)
 {
-	OrTools solver(node);
+	OrTools solver(instance);
 	auto clock_start = std::chrono::system_clock::now();
 	auto sol = solver.solve_problem();
 	auto clock_end = std::chrono::system_clock::now();
@@ -179,11 +180,11 @@ void direct_solve(nodes& node, NodesDistance& distance, std::ofstream& output)
 	output << "cost: " << sol.total_cost << "    vehicles: " << sol.number_vehicles << "    elapsed time: " << elapsed << std::endl;
 }
 
-void solve_from_voronoi(nodes& node, NodesDistance& distance, int n_part, std::ofstream& output)
+void solve_from_voronoi(std::shared_ptr<const Instance> instance, NodesDistance& distance, int n_part, std::ofstream& output)
 {
-	OrTools solver(node);
+	OrTools solver(instance);
 	auto clock_start = std::chrono::system_clock::now();
-	Voronoi voro(node, distance);
+	Voronoi voro(instance, distance);
 	auto part = voro.voronoi_part(n_part);
 	compact_solution solution;
 	for (auto i = 0; i < part.size(); i++)
@@ -197,9 +198,9 @@ void solve_from_voronoi(nodes& node, NodesDistance& distance, int n_part, std::o
 	output << "cost: " << sol.total_cost << "    vehicles: " << sol.number_vehicles << "    elapsed time: " << elapsed << std::endl;
 }
 
-void solve_from_genetic(nodes& node, NodesDistance& distance, int n_part, std::ofstream& output)
+void solve_from_genetic(std::shared_ptr<const Instance> instance, NodesDistance& distance, int n_part, std::ofstream& output)
 {
-	OrTools solver(node);
+	OrTools solver(instance);
 	auto clock_start = std::chrono::system_clock::now();
 	GeneticEvolution genetic(distance);
 	auto part = genetic.genetic_part(n_part);
@@ -215,9 +216,9 @@ void solve_from_genetic(nodes& node, NodesDistance& distance, int n_part, std::o
 	output << "cost: " << sol.total_cost << "    vehicles: " << sol.number_vehicles << "    elapsed time: " << elapsed << std::endl;
 }
 
-void solve_from_medoid(nodes& node, NodesDistance& distance, int n_part, std::ofstream& output)
+void solve_from_medoid(std::shared_ptr<const Instance> instance, NodesDistance& distance, int n_part, std::ofstream& output)
 {
-	OrTools solver(node);
+	OrTools solver(instance);
 	auto clock_start = std::chrono::system_clock::now();
 	KMedoid medoid(distance);
 	auto part = medoid.medoid_part(n_part);
@@ -252,35 +253,35 @@ int main()
 		for (auto file = 0; file < filename.size(); file++)
 		{
 			std::ofstream report(output_folder[n] + "Sreport" + filename[file], std::ofstream::out | std::ofstream::trunc);
-			nodes node;
-			init_nodes(node, input_folder + filename[file]);
-			Spatial spatial(node);
+			//nodes, distances and travel times are computed once and shared by every repetition
+			auto instance = std::make_shared<const Instance>(input_folder + filename[file]);
+			Spatial spatial(instance);
 
 			report << "solve with genetic partition:" << std::endl;
 			for (auto i = 0; i < n_iter; i++)
 			{
-				i += genetic_solve_concurrent(node, spatial, n_part[n], report);
+				i += genetic_solve_concurrent(instance, spatial, n_part[n], report);
 			}
 			report << std::endl;
 
 			report << "solve with K-medoid partition:" << std::endl;
 			for (auto i = 0; i < n_iter; i++)
 			{
-				i += medoid_solve_concurrent(node, spatial, n_part[n], report);
+				i += medoid_solve_concurrent(instance, spatial, n_part[n], report);
 			}
 			report << std::endl;
 
 			report << "solve with balanced voronoi partition:" << std::endl;
 			for (auto i = 0; i < n_iter; i++)
 			{
-				i += voronoi_solve_concurrent(node, spatial, n_part[n], report, true);
+				i += voronoi_solve_concurrent(instance, spatial, n_part[n], report, true);
 			}
 			report << std::endl;
 
 			report << "solve with strongest voronoi partition:" << std::endl;
 			for (auto i = 0; i < n_iter; i++)
 			{
-				i += voronoi_solve_concurrent(node, spatial, n_part[n], report, false);
+				i += voronoi_solve_concurrent(instance, spatial, n_part[n], report, false);
 			}
 			report << std::endl;
 
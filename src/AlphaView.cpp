@@ -0,0 +1,54 @@
+#include "AlphaView.h"
+
+AlphaView::AlphaView(SpatioTemporal& source, double alpha1) : NodesDistance::NodesDistance(source)
+{
+	this->source = &source;
+
+	//neighbours of the source are sorted with its own alpha
+	this->neighbour = neighbour_lists();
+
+	if (alpha1 >= 0.0 && alpha1 <= 1.0)
+	{
+		this->alpha1 = alpha1;
+		this->alpha2 = 1.0 - alpha1;
+	}
+
+	this->min_distance = source.min_distance;
+	this->max_distance = source.max_distance;
+	this->min_time = source.min_time;
+	this->max_time = source.max_time;
+}
+
+void AlphaView::materialize(int workers)
+{
+	if (this->materialized)
+		return;
+
+	//same layout of the source, a packed source gives a packed view
+	this->matrix.resize(this->size, this->source->spatio_temporal_matrix.get_layout());
+
+	parallel_for(this->size, [this](int i, int worker)
+	{
+		for (auto j = i; j < this->size; j++)
+		{
+			this->matrix.set_symmetric(i, j, this->fused(i, j));
+		}
+	}, workers);
+
+	this->materialized = true;
+}
+
+double AlphaView::get_distance(int from_id, int to_id)
+{
+	return this->distance(from_id, to_id);
+}
+
+double AlphaView::get_alpha() const
+{
+	return this->alpha1;
+}
+
+std::size_t AlphaView::get_memory()
+{
+	return this->matrix.bytes();
+}
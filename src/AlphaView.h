@@ -0,0 +1,151 @@
+#pragma once
+#include "NodesDistance.h"
+#include "SpatioTemporal.h"
+#include "DistanceMatrix.h"
+#include "ParallelFor.h"
+#include "StoredDistance.h"
+#include <vector>
+
+/**
+* NodesDistance's derived class
+* spatiotemporal distance with a different alpha1 over the spatial and temporal matrices of an existing SpatioTemporal
+*
+* Spatial and temporal matrices, together with their min and max, do not depend on alpha1: a view reuses them and
+* combines the scaled values on the fly, so a sweep over many alphas computes the matrices once.
+* Values are the same of a SpatioTemporal built with the same alpha1 (and the same k1, k2, k3).
+* A view can also materialize its own matrix, when the distance is read many times (e.g. by GeneticEvolution).
+*
+* The SpatioTemporal must outlive its views, many views can be used at the same time by different threads
+*
+*/
+class AlphaView final : public NodesDistance
+{
+public:
+	/**
+	* constructor
+	*
+	* input:
+	* source: reference to the SpatioTemporal that owns spatial and temporal matrices
+	* alpha1: multiplier of the spatial distance in [0; 1], alpha2 is 1 - alpha1
+	*
+	*/
+	AlphaView(SpatioTemporal& source, double alpha1);
+
+	/**
+	* computes and stores the distances of the view, after the call they are read from its own matrix
+	*
+	* input:
+	* workers: number of threads, 0 means all the available ones
+	*
+	*/
+	void materialize(int workers = 0);
+
+	/**
+	* implements NodesDistance's virtual function
+	*
+	* output:
+	* spatiotemporal distance between customer[from_id] and customer[to_id] with the alpha1 of the view
+	*
+	*/
+	double get_distance(int from_id, int to_id) override;
+
+	//non virtual version of get_distance (see Spatial::distance)
+	double distance(int from_id, int to_id) const
+	{
+		if (this->materialized)
+			return this->matrix.get(from_id, to_id);
+		return this->fused(from_id, to_id);
+	}
+
+	double get_alpha() const;
+
+	/**
+	* calls function with the distance policy of the view: its own matrix when materialized, otherwise the matrices
+	* of the source read with their precision known at compile time (see visit_distance)
+	*
+	* input:
+	* function: callable as function(Policy& distance) for every policy
+	*
+	* output:
+	* value returned by function
+	*
+	*/
+	template<class Function>
+	decltype(auto) visit(Function&& function)
+	{
+		if (this->materialized)
+		{
+			StoredDistance<double> policy(*this, TypedMatrix<double>(this->matrix));
+			return function(policy);
+		}
+
+		//temporal values have the precision of the spatial ones when computed by the source, not always when read from a snapshot
+		return this->source->spatial_matrix.visit([this, &function](const auto& spatial) -> decltype(auto)
+		{
+			using T = typename std::decay_t<decltype(spatial)>::value_type;
+			if (this->source->temporal_matrix.get_precision() != this->source->spatial_matrix.get_precision())
+				return function(*this);
+
+			FusedDistance<T> policy(*this, spatial, this->source->temporal_matrix.template typed<T>(), this->alpha1, this->alpha2,
+				this->min_distance, this->max_distance, this->min_time, this->max_time);
+			return function(policy);
+		});
+	}
+
+	//memory of the materialized matrix, matrices of the source are not counted
+	std::size_t get_memory() override;
+
+	/**
+	* runs a partitioner for every alpha, one alpha per thread
+	*
+	* input:
+	* source: reference to the SpatioTemporal that owns spatial and temporal matrices
+	* alphas: values of alpha1
+	* partition: callable as partition(AlphaView& view), returns the partition made with view
+	*			 (e.g. GeneticEvolution(view).genetic_part(groups))
+	* materialize: if true every view materializes its matrix before the partitioner starts
+	*
+	* output:
+	* partitions in the same order of alphas
+	*
+	*/
+	template<class Partition>
+	static std::vector<std::vector<std::vector<int>>> alpha_sweep(SpatioTemporal& source, const std::vector<double>& alphas, Partition partition, bool materialize = false)
+	{
+		std::vector<std::vector<std::vector<int>>> partitions(alphas.size());
+
+		parallel_for(int(alphas.size()), [&source, &alphas, &partition, &partitions, materialize](int task, int worker)
+		{
+			AlphaView view(source, alphas[task]);
+
+			//alphas already run in parallel
+			if (materialize)
+				view.materialize(1);
+
+			partitions[task] = partition(view);
+		});
+
+		return partitions;
+	}
+
+private:
+	//same expression used by SpatioTemporal, so the values are equal
+	double fused(int from_id, int to_id) const
+	{
+		if (from_id == to_id)
+			return 0.0;
+
+		return this->alpha1 * (this->source->spatial_matrix.get(from_id, to_id) - this->min_distance) / (this->max_distance - this->min_distance) +
+			this->alpha2 * (this->source->temporal_matrix.get(from_id, to_id) - this->min_time) / (this->max_time - this->min_time);
+	}
+
+	const SpatioTemporal* source;
+	double alpha1 = 0.5, alpha2 = 0.5;
+
+	//bounds of the source, copied to avoid an indirection for every distance
+	double min_distance = 0, max_distance = 0;
+	double min_time = 0, max_time = 0;
+
+	bool materialized = false;
+	DistanceMatrix<double> matrix;
+};
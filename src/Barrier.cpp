@@ -0,0 +1,22 @@
+#include "Barrier.h"
+
+Barrier::Barrier(int parties) : parties(parties)
+{
+}
+
+void Barrier::wait()
+{
+	std::unique_lock<std::mutex> lock(this->mutex);
+	auto generation = this->generation;
+
+	//the last thread releases the others
+	if (++this->waiting == this->parties)
+	{
+		this->waiting = 0;
+		this->generation++;
+		this->released.notify_all();
+		return;
+	}
+
+	this->released.wait(lock, [this, generation] { return this->generation != generation; });
+}
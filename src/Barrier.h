@@ -0,0 +1,38 @@
+#pragma once
+#include <condition_variable>
+#include <mutex>
+
+/**
+* reusable meeting point of a fixed number of threads: wait returns only when all of them have called it.
+* Everything written by a thread before wait is visible to the others after wait.
+* Used by GeneticEvolution::island_part, so that each migration reads what all the islands sent in the same generation
+*
+*/
+class Barrier
+{
+public:
+	/**
+	* constructor
+	*
+	* input:
+	* parties: number of threads that call wait at every meeting
+	*
+	*/
+	Barrier(int parties);
+
+	Barrier(const Barrier&) = delete;
+	Barrier& operator=(const Barrier&) = delete;
+
+	//blocks until all the threads have called wait, the barrier can then be used again
+	void wait();
+
+private:
+	std::mutex mutex;
+	std::condition_variable released;
+
+	int parties;
+	int waiting = 0;
+
+	//number of meetings completed, a thread leaves when it changes
+	long long generation = 0;
+};
@@ -0,0 +1,145 @@
+#include "CompatibilityIndex.h"
+#include "DistanceKernels.h"
+#include "ParallelFor.h"
+#include <algorithm>
+#include <numeric>
+
+CompatibilityIndex::CompatibilityIndex(const nodes& node, int workers)
+{
+	this->init(node);
+
+	std::vector<double> x(this->size), y(this->size);
+	for (auto i = 0; i < this->size; i++)
+	{
+		x[i] = node.coord[i][0];
+		y[i] = node.coord[i][1];
+	}
+
+	//a row of travel times for each thread
+	std::vector<std::vector<double>> travel(workers > 0 ? workers : worker_count(), std::vector<double>(this->size));
+	parallel_for(this->size, [this, &x, &y, &travel](int i, int worker)
+	{
+		euclidean_row(x.data(), y.data(), i, 0, this->size, travel[worker].data(), nullptr);
+		this->fill_row(i, travel[worker].data());
+	}, workers);
+}
+
+CompatibilityIndex::CompatibilityIndex(const nodes& node, const std::vector<std::vector<int>>& time_matrix, int workers)
+{
+	this->init(node);
+
+	parallel_for(this->size, [this, &time_matrix](int i, int worker)
+	{
+		this->fill_row(i, time_matrix[i].data());
+	}, workers);
+}
+
+CompatibilityIndex::CompatibilityIndex(const nodes& node, const DistanceMatrix<int>& time_matrix, int workers)
+{
+	this->init(node);
+
+	parallel_for(this->size, [this, &time_matrix](int i, int worker)
+	{
+		this->fill_row(i, time_matrix.row(i));
+	}, workers);
+}
+
+void CompatibilityIndex::init(const nodes& node)
+{
+	this->size = node.id.size();
+	this->words = (this->size + 63) / 64;
+	this->bits.assign(this->size * this->words, 0);
+
+	this->ready.resize(this->size);
+	this->due.resize(this->size);
+	this->service.resize(this->size);
+	for (auto i = 0; i < this->size; i++)
+	{
+		this->ready[i] = node.time_window[i][0];
+		this->due[i] = node.time_window[i][1];
+		this->service[i] = node.service_time[i];
+	}
+
+	this->due_order.resize(this->size);
+	std::iota(this->due_order.begin(), this->due_order.end(), 0);
+	std::stable_sort(this->due_order.begin(), this->due_order.end(), [this](int a, int b)
+	{
+		return this->due[a] < this->due[b];
+	});
+
+	this->sorted_due.resize(this->size);
+	for (auto i = 0; i < this->size; i++)
+	{
+		this->sorted_due[i] = this->due[this->due_order[i]];
+	}
+}
+
+template<class Travel>
+void CompatibilityIndex::fill_row(int from_id, const Travel* travel)
+{
+	auto earliest = this->ready[from_id] + this->service[from_id];
+	auto row = this->bits.data() + std::size_t(from_id) * this->words;
+
+	//64 comparisons give a word, the inner loop has no branches and is vectorized
+	for (std::size_t word = 0; word < this->words; word++)
+	{
+		int begin = word * 64;
+		int end = std::min(begin + 64, this->size);
+
+		std::uint64_t value = 0;
+		for (auto j = begin; j < end; j++)
+		{
+			value |= std::uint64_t(earliest + travel[j] <= this->due[j]) << (j - begin);
+		}
+		row[word] = value;
+	}
+
+	row[from_id >> 6] &= ~(std::uint64_t(1) << (from_id & 63));
+}
+
+const std::uint64_t* CompatibilityIndex::row(int from_id) const
+{
+	return this->bits.data() + std::size_t(from_id) * this->words;
+}
+
+int CompatibilityIndex::count(int from_id) const
+{
+	auto bits = this->row(from_id);
+	int total = 0;
+	for (std::size_t word = 0; word < this->words; word++)
+	{
+		//popcount
+		for (auto value = bits[word]; value != 0; value &= value - 1)
+			total++;
+	}
+	return total;
+}
+
+double CompatibilityIndex::density() const
+{
+	if (this->size < 2)
+		return 0;
+
+	std::size_t total = 0;
+	for (auto i = 0; i < this->size; i++)
+	{
+		total += this->count(i);
+	}
+	return double(total) / (double(this->size) * (this->size - 1));
+}
+
+std::pair<const int*, const int*> CompatibilityIndex::due_after(double time) const
+{
+	auto first = std::lower_bound(this->sorted_due.begin(), this->sorted_due.end(), time) - this->sorted_due.begin();
+	return { this->due_order.data() + first, this->due_order.data() + this->size };
+}
+
+int CompatibilityIndex::get_size() const
+{
+	return this->size;
+}
+
+std::size_t CompatibilityIndex::get_memory() const
+{
+	return this->bits.size() * sizeof(std::uint64_t);
+}
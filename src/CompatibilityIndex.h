@@ -0,0 +1,92 @@
+#pragma once
+#include "NodesDistance.h"
+#include "DistanceMatrix.h"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+* which customers can be served after which ones, from the time windows alone
+*
+* Customer j can follow customer i when ready(i) + service(i) + travel(i, j) <= due(j): otherwise a vehicle
+* leaving i at the earliest reaches j too late, whatever the route. The answers of all pairs are kept in
+* an n x n bitset (n^2 / 8 bytes), rows are built in parallel from the vectorized distance kernels.
+* Pairs with i == j are never compatible.
+* An interval index over the due dates gives the customers that can follow a time without any travel.
+*
+* With tight time windows (e.g. R1 and C1 instances) most pairs are incompatible, the bitset is a cheap
+* filter for the partitioners and for the arcs of OrTools (see OrTools::set_preprocessing)
+*
+*/
+class CompatibilityIndex
+{
+public:
+	/**
+	* constructor with Euclidean travel times, as SpatioTemporal
+	*
+	* input
+	* node: reference to an existing struct nodes
+	* workers: number of threads, 0 means all the available ones
+	*
+	*/
+	CompatibilityIndex(const nodes& node, int workers = 0);
+
+	/**
+	* constructors with given travel times, e.g. the ones of an Instance or of a RoadDistance
+	*
+	* input
+	* node: reference to an existing struct nodes
+	* time_matrix: square matrix of travel times between customers (full layout for a DistanceMatrix)
+	* workers: number of threads, 0 means all the available ones
+	*
+	*/
+	CompatibilityIndex(const nodes& node, const std::vector<std::vector<int>>& time_matrix, int workers = 0);
+	CompatibilityIndex(const nodes& node, const DistanceMatrix<int>& time_matrix, int workers = 0);
+
+	//true if customer to_id can be served after customer from_id
+	bool compatible(int from_id, int to_id) const
+	{
+		return (this->bits[std::size_t(from_id) * this->words + (to_id >> 6)] >> (to_id & 63)) & 1u;
+	}
+
+	//bits of the customers that can follow from_id, (get_size() + 63) / 64 words
+	const std::uint64_t* row(int from_id) const;
+
+	//number of customers that can follow from_id
+	int count(int from_id) const;
+
+	//fraction of compatible pairs
+	double density() const;
+
+	/**
+	* interval index: customers whose due date is not before time, by increasing due date.
+	* Customers that can follow i are among the ones given by due_after(ready(i) + service(i))
+	*
+	* output:
+	* range [first; last) of customer ids
+	*
+	*/
+	std::pair<const int*, const int*> due_after(double time) const;
+
+	int get_size() const;
+
+	//memory of the bitset in bytes
+	std::size_t get_memory() const;
+
+private:
+	void init(const nodes& node);
+
+	//fills the bits of from_id from the travel times to every customer
+	template<class Travel>
+	void fill_row(int from_id, const Travel* travel);
+
+	int size = 0;
+	std::size_t words = 0;
+	std::vector<std::uint64_t> bits;
+
+	std::vector<double> ready, due, service;
+
+	//customer ids sorted by due date, and their due dates
+	std::vector<int> due_order;
+	std::vector<double> sorted_due;
+};
@@ -13,23 +13,50 @@ typename std::conditional<
 >::type;
 
 
+inline std::default_random_engine& thread_random_engine()
+{
+	//threads started in the same second must not share the sequence, random_device may also be deterministic on some platforms
+	static std::atomic<unsigned> threads{ 0 };
+	thread_local static std::default_random_engine engine = []
+	{
+		std::random_device device;
+		std::seed_seq seed{ device(), unsigned(std::time(0)), threads++ };
+		return std::default_random_engine(seed);
+	}();
+
+	return engine;
+}
+
 template<class T>
 ConsecutiveRandoms<T>::ConsecutiveRandoms(T min, T max)
 {
 	this->nodes_id_generator = new uniform_distribution<T>(min, max);
 }
 
+template<class T>
+ConsecutiveRandoms<T>::ConsecutiveRandoms(T min, T max, std::default_random_engine& engine) : ConsecutiveRandoms(min, max)
+{
+	this->engine = &engine;
+}
+
 template<class T>
 T ConsecutiveRandoms<T>::generate()
 {
-	static std::default_random_engine default_engine(std::time(0));
-	return this->nodes_id_generator->operator()(default_engine);
+	if (this->engine != nullptr)
+		return this->nodes_id_generator->operator()(*this->engine);
+
+	//one engine per thread, partitioners can run in parallel
+	return this->nodes_id_generator->operator()(thread_random_engine());
 }
 
 template<class T>
 T ConsecutiveRandoms<T>::generate(T min, T max)
 {
-	static std::default_random_engine default_engine(std::time(0));
-	return uniform_distribution<T>(min, max)(default_engine);
+	return uniform_distribution<T>(min, max)(thread_random_engine());
 }
 
+template<class T>
+T ConsecutiveRandoms<T>::generate(T min, T max, std::default_random_engine& engine)
+{
+	return uniform_distribution<T>(min, max)(engine);
+}
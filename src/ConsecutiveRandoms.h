@@ -1,6 +1,7 @@
 #pragma once
 #include <random>
 #include <ctime>
+#include <atomic>
 
 //template that transforms uniform_distribution in std::uniform_int_distribution<T> in case of integers or in uniform_real_distribution<T> in case of floating point 
 template<class T>
@@ -16,6 +17,13 @@ typename std::conditional<
 >::type;
 
 
+/**
+* engine of the calling thread, used when no engine is given to ConsecutiveRandoms.
+* Every thread has its own sequence, also when many threads start together (e.g. AlphaView::alpha_sweep)
+*
+*/
+inline std::default_random_engine& thread_random_engine();
+
 /**
 * class that generates random numbers in a given interval.
 * numbers can be either integers or floating point
@@ -39,6 +47,17 @@ public:
 	*/
 	ConsecutiveRandoms(T min, T max);
 
+	/**
+	* contructor with a given engine, e.g. a seeded stream of a single task. Numbers do not depend on the thread
+	* that generates them
+	*
+	* input:
+	* min, max: same as above
+	* engine: reference to the engine used by generate, must outlive this object
+	*
+	*/
+	ConsecutiveRandoms(T min, T max, std::default_random_engine& engine);
+
 	/**
 	* function that generates a random number
 	* 
@@ -60,11 +79,15 @@ public:
 	* 
 	*/
 	static T generate(T min, T max);
+	static T generate(T min, T max, std::default_random_engine& engine);
 
 private:
 
 	uniform_distribution<T>* nodes_id_generator;
 
+	//given engine, nullptr if the one of the thread is used
+	std::default_random_engine* engine = nullptr;
+
 };
 
 //needed because otherwise the template is not usable in the header file
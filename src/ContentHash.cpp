@@ -0,0 +1,46 @@
+#include "ContentHash.h"
+#include <cstring>
+
+static const std::uint64_t hash_multiplier = 0x9E3779B97F4A7C15ull;
+
+//final mix of MurmurHash3, every input bit affects every output bit
+static std::uint64_t avalanche(std::uint64_t value)
+{
+	value ^= value >> 33;
+	value *= 0xFF51AFD7ED558CCDull;
+	value ^= value >> 33;
+	value *= 0xC4CEB9FE1A85EC53ull;
+	value ^= value >> 33;
+	return value;
+}
+
+static std::uint64_t combine(std::uint64_t hash, std::uint64_t word)
+{
+	hash ^= avalanche(word);
+	hash = (hash << 27) | (hash >> 37);
+	return hash * hash_multiplier + 0x52DCE729ull;
+}
+
+std::uint64_t content_hash(const void* data, std::size_t bytes, std::uint64_t seed)
+{
+	auto begin = static_cast<const unsigned char*>(data);
+	auto hash = avalanche(seed ^ (bytes * hash_multiplier));
+
+	//8 bytes at a time, memcpy avoids unaligned reads
+	std::size_t i = 0;
+	for (; i + 8 <= bytes; i += 8)
+	{
+		std::uint64_t word;
+		std::memcpy(&word, begin + i, 8);
+		hash = combine(hash, word);
+	}
+
+	if (i < bytes)
+	{
+		std::uint64_t word = 0;
+		std::memcpy(&word, begin + i, bytes - i);
+		hash = combine(hash, word);
+	}
+
+	return avalanche(hash);
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/**
+* 64 bits non-cryptographic hash of a block of memory, used to identify instances and to detect
+* corrupted files. Values do not depend on the alignment of data, but they depend on the byte order
+*
+* input:
+* data: first byte of the block
+* bytes: size of the block
+* seed: previous hash when many blocks are chained, 0 otherwise
+*
+* output:
+* hash of the block
+*
+*/
+std::uint64_t content_hash(const void* data, std::size_t bytes, std::uint64_t seed = 0);
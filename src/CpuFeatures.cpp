@@ -0,0 +1,70 @@
+#include "CpuFeatures.h"
+#include <atomic>
+
+#if SIMD_X86 && defined(_MSC_VER)
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+static simd_level detect_simd_level()
+{
+#if SIMD_X86 && defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] < 7)
+		return simd_level::scalar;
+
+	//operating system must save the ymm (and zmm) registers
+	__cpuid(info, 1);
+	bool osxsave = (info[2] & (1 << 27)) != 0;
+	if (!osxsave)
+		return simd_level::scalar;
+	auto xcr0 = _xgetbv(0);
+
+	__cpuid(info, 7);
+	bool avx2 = (info[1] & (1 << 5)) != 0 && (xcr0 & 0x6) == 0x6;
+	bool avx512 = (info[1] & (1 << 16)) != 0 && (xcr0 & 0xe6) == 0xe6;
+
+	if (avx512)
+		return simd_level::avx512;
+	if (avx2)
+		return simd_level::avx2;
+	return simd_level::scalar;
+#elif SIMD_X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512f"))
+		return simd_level::avx512;
+	if (__builtin_cpu_supports("avx2"))
+		return simd_level::avx2;
+	return simd_level::scalar;
+#else
+	return simd_level::scalar;
+#endif
+}
+
+static std::atomic<int> forced_level(int(simd_level::avx512));
+
+simd_level active_simd_level()
+{
+	static const simd_level detected = detect_simd_level();
+	auto forced = simd_level(forced_level.load(std::memory_order_relaxed));
+	return forced < detected ? forced : detected;
+}
+
+void force_simd_level(simd_level level)
+{
+	forced_level.store(int(level), std::memory_order_relaxed);
+}
+
+const char* simd_level_name(simd_level level)
+{
+	switch (level)
+	{
+	case simd_level::avx512:
+		return "avx512";
+	case simd_level::avx2:
+		return "avx2";
+	default:
+		return "scalar";
+	}
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+/**
+* instruction sets used by the vectorized kernels
+*
+*/
+enum class simd_level
+{
+	scalar,
+	avx2,
+	avx512
+};
+
+//the kernels for the x86 instruction sets are compiled only on x86 targets
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SIMD_X86 1
+#else
+#define SIMD_X86 0
+#endif
+
+//allows the use of intrinsics of an instruction set inside a single function (MSVC does not need it)
+#if SIMD_X86 && (defined(__GNUC__) || defined(__clang__))
+#define SIMD_TARGET(features) __attribute__((target(features)))
+#else
+#define SIMD_TARGET(features)
+#endif
+
+/**
+* instruction set used by the kernels
+*
+* output:
+* best instruction set supported by both cpu and operating system, unless a lower one has been forced
+*
+*/
+simd_level active_simd_level();
+
+/**
+* limits the instruction set used by the kernels, e.g. for comparing implementations.
+* A level that is not supported by the cpu is lowered to the best supported one
+*
+* input:
+* level: highest instruction set that can be used
+*
+*/
+void force_simd_level(simd_level level);
+
+//name of the instruction set: "scalar", "avx2" or "avx512"
+const char* simd_level_name(simd_level level);
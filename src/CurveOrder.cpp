@@ -0,0 +1,157 @@
+#include "CurveOrder.h"
+#include <algorithm>
+#include <utility>
+
+//bits of every quantized coordinate, 3 * 16 bits fit a key
+static const int key_bits = 16;
+
+CurveOrder::CurveOrder(const nodes& node, space_curve curve, index_axes axes)
+{
+	int size = node.id.size();
+	int dimensions = axes == index_axes::temporal ? 3 : 2;
+
+	//points as SpatialIndex, the third axis is the one of Spatial3d
+	std::vector<index_point> points(size);
+	index_point low = {}, high = {};
+	for (auto i = 0; i < size; i++)
+	{
+		points[i] = { double(node.coord[i][0]), double(node.coord[i][1]), node.time_window[i][0] + node.time_window[i][1] / 2.0 };
+		for (auto axis = 0; axis < dimensions; axis++)
+		{
+			low[axis] = i == 0 ? points[i][axis] : std::min(low[axis], points[i][axis]);
+			high[axis] = i == 0 ? points[i][axis] : std::max(high[axis], points[i][axis]);
+		}
+	}
+
+	//(key, position) of every customer, the depot is left out
+	std::vector<std::pair<std::uint64_t, int>> keys;
+	keys.reserve(size);
+	for (auto i = 1; i < size; i++)
+	{
+		std::uint32_t axis[3] = {};
+		for (auto j = 0; j < dimensions; j++)
+		{
+			auto range = high[j] - low[j];
+			axis[j] = range > 0 ? std::uint32_t((points[i][j] - low[j]) / range * ((1 << key_bits) - 1)) : 0;
+		}
+
+		keys.push_back({ curve == space_curve::hilbert ? hilbert_key(axis, dimensions) : morton_key(axis, dimensions), i });
+	}
+
+	//equal keys keep the original order
+	std::sort(keys.begin(), keys.end());
+
+	this->original_id.resize(size);
+	this->position.resize(size);
+	if (size == 0)
+		return;
+
+	this->original_id[0] = node.id[0];
+	this->position[0] = 0;
+	for (auto i = 0; i < keys.size(); i++)
+	{
+		this->original_id[i + 1] = node.id[keys[i].second];
+		this->position[keys[i].second] = i + 1;
+	}
+}
+
+std::uint64_t CurveOrder::hilbert_key(std::uint32_t* axis, int dimensions)
+{
+	//Skilling's transform of the coordinates, the key is made by interleaving the transposed bits
+	std::uint32_t highest = 1u << (key_bits - 1);
+
+	for (auto q = highest; q > 1; q >>= 1)
+	{
+		auto p = q - 1;
+		for (auto i = 0; i < dimensions; i++)
+		{
+			if (axis[i] & q)
+			{
+				axis[0] ^= p;
+			}
+			else
+			{
+				auto t = (axis[0] ^ axis[i]) & p;
+				axis[0] ^= t;
+				axis[i] ^= t;
+			}
+		}
+	}
+
+	//Gray encoding
+	for (auto i = 1; i < dimensions; i++)
+	{
+		axis[i] ^= axis[i - 1];
+	}
+
+	std::uint32_t t = 0;
+	for (auto q = highest; q > 1; q >>= 1)
+	{
+		if (axis[dimensions - 1] & q)
+			t ^= q - 1;
+	}
+
+	for (auto i = 0; i < dimensions; i++)
+	{
+		axis[i] ^= t;
+	}
+
+	return morton_key(axis, dimensions);
+}
+
+std::uint64_t CurveOrder::morton_key(const std::uint32_t* axis, int dimensions)
+{
+	std::uint64_t key = 0;
+	for (auto bit = key_bits - 1; bit >= 0; bit--)
+	{
+		for (auto i = 0; i < dimensions; i++)
+		{
+			key = (key << 1) | ((axis[i] >> bit) & 1u);
+		}
+	}
+	return key;
+}
+
+nodes CurveOrder::reorder(const nodes& node) const
+{
+	int size = node.id.size();
+	nodes reordered;
+	reordered.vehicles = node.vehicles;
+	reordered.capacity = node.capacity;
+	reordered.id.resize(size);
+	reordered.coord.resize(size);
+	reordered.time_window.resize(size);
+	reordered.demand.resize(size);
+	reordered.service_time.resize(size);
+
+	for (auto i = 0; i < size; i++)
+	{
+		auto j = this->position[i];
+		reordered.id[j] = j;
+		reordered.coord[j] = node.coord[i];
+		reordered.time_window[j] = node.time_window[i];
+		reordered.demand[j] = node.demand[i];
+		reordered.service_time[j] = node.service_time[i];
+	}
+
+	return reordered;
+}
+
+int CurveOrder::original(int customer) const
+{
+	return this->original_id[customer];
+}
+
+int CurveOrder::renumbered(int customer) const
+{
+	return this->position[customer];
+}
+
+void CurveOrder::restore(std::vector<std::vector<int>>& groups) const
+{
+	for (auto& group : groups)
+	{
+		for (auto& customer : group)
+			customer = this->original_id[customer];
+	}
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include "NodesDistance.h"
+#include "SpatialIndex.h"
+#include <cstdint>
+#include <vector>
+
+//space filling curves used by CurveOrder
+enum class space_curve
+{
+	//consecutive keys are always neighbouring cells, best locality
+	hilbert,
+
+	//interleaved bits of the coordinates, cheaper but with jumps between quadrants
+	morton
+};
+
+/**
+* renumbering of the customers along a space filling curve over their coordinates, optionally with the
+* time window value used by Spatial3d as third axis (see index_axes)
+*
+* Customer ids in the instance files follow no spatial order, so the rows of a cluster are scattered over
+* every matrix. Matrices built on the reordered nodes (see reorder) keep near customers in near rows, the
+* partitioners and the sub-matrices of OrTools::solve_sub_problem then read them almost sequentially.
+* The depot stays in 0, restore maps the results back to the original ids.
+*
+*/
+class CurveOrder
+{
+public:
+	/**
+	* constructor
+	*
+	* input
+	* node: reference to an existing struct nodes
+	* curve: hilbert or morton
+	* axes: planar or temporal keys
+	*
+	*/
+	CurveOrder(const nodes& node, space_curve curve = space_curve::hilbert, index_axes axes = index_axes::planar);
+
+	/**
+	* copy of node in the order of the curve, customers are renumbered so that id[i] is i
+	*
+	* input
+	* node: the same struct nodes given to the constructor
+	*
+	*/
+	nodes reorder(const nodes& node) const;
+
+	//original id of a renumbered customer
+	int original(int customer) const;
+
+	//renumbered id of a customer of the original nodes
+	int renumbered(int customer) const;
+
+	/**
+	* maps renumbered ids back to the original ones
+	*
+	* input:
+	* groups: partition or routes made on the reordered nodes, changed in place
+	*
+	*/
+	void restore(std::vector<std::vector<int>>& groups) const;
+
+private:
+	//original id by renumbered id, and position in the reordered nodes by position in the original ones
+	std::vector<int> original_id;
+	std::vector<int> position;
+
+	//key of a point with quantized coordinates
+	static std::uint64_t hilbert_key(std::uint32_t* axis, int dimensions);
+	static std::uint64_t morton_key(const std::uint32_t* axis, int dimensions);
+};
@@ -0,0 +1,539 @@
+#include "DistanceKernels.h"
+#include "CpuFeatures.h"
+#include <cmath>
+
+#include <algorithm>
+
+#if SIMD_X86
+#include <immintrin.h>
+#endif
+
+//multiplications and additions must not be fused, otherwise vectorized kernels would round differently from the scalar ones
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#elif defined(_MSC_VER)
+#pragma fp_contract(off)
+#endif
+
+/*
+* coordinates are integers, so squared differences and their sums are exact in double precision and
+* every implementation gives the same results of std::sqrt(std::pow(dx, 2) + std::pow(dy, 2))
+*/
+
+static void euclidean_row_scalar(const double* x, const double* y, int from_id, int begin, int end, double* distance, int* time)
+{
+	auto from_x = x[from_id];
+	auto from_y = y[from_id];
+
+	for (auto j = begin; j < end; j++)
+	{
+		auto dx = from_x - x[j];
+		auto dy = from_y - y[j];
+		auto squared = dx * dx + dy * dy;
+
+		if (distance != nullptr)
+			distance[j - begin] = std::sqrt(squared);
+		if (time != nullptr)
+			time[j - begin] = int(std::sqrt(squared + 0.5));
+	}
+}
+
+static void euclidean3d_row_scalar(const double* x, const double* y, const double* z, int from_id, int begin, int end, double* distance)
+{
+	auto from_x = x[from_id];
+	auto from_y = y[from_id];
+	auto from_z = z[from_id];
+
+	for (auto j = begin; j < end; j++)
+	{
+		auto dx = from_x - x[j];
+		auto dy = from_y - y[j];
+		auto dz = from_z - z[j];
+		distance[j - begin] = std::sqrt(dx * dx + dy * dy + dz * dz);
+	}
+}
+
+/*
+* temporal distance from a customer with arrival time window [from_ready; from_due] + offset to a customer with time window [to_ready; to_due].
+* Same operations in the same order of SpatioTemporal::temporal_distance, the vectorized kernels repeat them lane by lane
+*/
+static double temporal_scalar(double from_ready, double from_due, double offset, double to_ready, double to_due, const temporal_parameters& parameters)
+{
+	auto k1 = parameters.k1, k2 = parameters.k2, k3 = parameters.k3;
+	auto marked_ready = from_ready + offset;
+	auto marked_due = from_due + offset;
+
+	auto early_arrival = [=](double marked_t)
+	{
+		return k2 * (marked_t * marked_t) / 2.0 + k1 * to_due * marked_t - (k1 * to_ready * marked_t + k2 * to_ready * marked_t);
+	};
+
+	auto good_arrival = [=](double marked_t)
+	{
+		return k1 * -1.0 * (marked_t * marked_t) / 2.0 + k1 * to_due * marked_t;
+	};
+
+	auto late_arrival = [=](double marked_t)
+	{
+		return k3 * -1.0 * (marked_t * marked_t) / 2.0 + k3 * to_due * marked_t;
+	};
+
+	return k1 * parameters.max_width -
+		(
+			early_arrival(std::min(marked_due, to_ready)) - early_arrival(std::min(marked_ready, to_ready)) +
+			good_arrival(std::max(std::min(marked_due, to_due), to_ready)) - good_arrival(std::min(std::max(marked_ready, to_ready), to_due)) +
+			late_arrival(std::max(marked_due, to_due)) - late_arrival(std::max(marked_ready, to_due))
+			) / (marked_due - marked_ready);
+}
+
+static void temporal_row_scalar(const double* ready, const double* due, const double* service, const double* travel,
+	int from_id, int begin, int end, const temporal_parameters& parameters, double* distance)
+{
+	for (auto j = begin; j < end; j++)
+	{
+		auto forward = temporal_scalar(ready[from_id], due[from_id], service[from_id] + travel[j - begin], ready[j], due[j], parameters);
+		auto backward = temporal_scalar(ready[j], due[j], service[j] + travel[j - begin], ready[from_id], due[from_id], parameters);
+		distance[j - begin] = std::min(forward, backward);
+	}
+}
+
+static double nearest_rows_scalar(const double* rows, int k, std::size_t stride, int count, double* nearest, int* label, double total)
+{
+	for (auto i = 0; i < count; i++)
+	{
+		auto min = rows[i];
+		auto position = 0;
+		for (auto j = 1; j < k; j++)
+		{
+			auto value = rows[j * stride + i];
+			if (value < min)
+			{
+				min = value;
+				position = j;
+			}
+		}
+
+		if (nearest != nullptr)
+			nearest[i] = min;
+		if (label != nullptr)
+			label[i] = position;
+		total += min;
+	}
+
+	return total;
+}
+
+#if SIMD_X86
+
+SIMD_TARGET("avx2")
+static void euclidean_row_avx2(const double* x, const double* y, int from_id, int begin, int end, double* distance, int* time)
+{
+	auto from_x = _mm256_set1_pd(x[from_id]);
+	auto from_y = _mm256_set1_pd(y[from_id]);
+	auto half = _mm256_set1_pd(0.5);
+
+	auto j = begin;
+	for (; j + 4 <= end; j += 4)
+	{
+		auto dx = _mm256_sub_pd(from_x, _mm256_loadu_pd(x + j));
+		auto dy = _mm256_sub_pd(from_y, _mm256_loadu_pd(y + j));
+		auto squared = _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy));
+
+		if (distance != nullptr)
+			_mm256_storeu_pd(distance + (j - begin), _mm256_sqrt_pd(squared));
+		if (time != nullptr)
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(time + (j - begin)), _mm256_cvttpd_epi32(_mm256_sqrt_pd(_mm256_add_pd(squared, half))));
+	}
+
+	//last customers that do not fill a register
+	euclidean_row_scalar(x, y, from_id, j, end, distance ? distance + (j - begin) : nullptr, time ? time + (j - begin) : nullptr);
+}
+
+SIMD_TARGET("avx2")
+static void euclidean3d_row_avx2(const double* x, const double* y, const double* z, int from_id, int begin, int end, double* distance)
+{
+	auto from_x = _mm256_set1_pd(x[from_id]);
+	auto from_y = _mm256_set1_pd(y[from_id]);
+	auto from_z = _mm256_set1_pd(z[from_id]);
+
+	auto j = begin;
+	for (; j + 4 <= end; j += 4)
+	{
+		auto dx = _mm256_sub_pd(from_x, _mm256_loadu_pd(x + j));
+		auto dy = _mm256_sub_pd(from_y, _mm256_loadu_pd(y + j));
+		auto dz = _mm256_sub_pd(from_z, _mm256_loadu_pd(z + j));
+		auto squared = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy)), _mm256_mul_pd(dz, dz));
+		_mm256_storeu_pd(distance + (j - begin), _mm256_sqrt_pd(squared));
+	}
+
+	euclidean3d_row_scalar(x, y, z, from_id, j, end, distance + (j - begin));
+}
+
+SIMD_TARGET("avx512f")
+static void euclidean_row_avx512(const double* x, const double* y, int from_id, int begin, int end, double* distance, int* time)
+{
+	auto from_x = _mm512_set1_pd(x[from_id]);
+	auto from_y = _mm512_set1_pd(y[from_id]);
+	auto half = _mm512_set1_pd(0.5);
+
+	auto j = begin;
+	for (; j + 8 <= end; j += 8)
+	{
+		auto dx = _mm512_sub_pd(from_x, _mm512_loadu_pd(x + j));
+		auto dy = _mm512_sub_pd(from_y, _mm512_loadu_pd(y + j));
+		auto squared = _mm512_add_pd(_mm512_mul_pd(dx, dx), _mm512_mul_pd(dy, dy));
+
+		if (distance != nullptr)
+			_mm512_storeu_pd(distance + (j - begin), _mm512_sqrt_pd(squared));
+		if (time != nullptr)
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(time + (j - begin)), _mm512_cvttpd_epi32(_mm512_sqrt_pd(_mm512_add_pd(squared, half))));
+	}
+
+	euclidean_row_scalar(x, y, from_id, j, end, distance ? distance + (j - begin) : nullptr, time ? time + (j - begin) : nullptr);
+}
+
+SIMD_TARGET("avx512f")
+static void euclidean3d_row_avx512(const double* x, const double* y, const double* z, int from_id, int begin, int end, double* distance)
+{
+	auto from_x = _mm512_set1_pd(x[from_id]);
+	auto from_y = _mm512_set1_pd(y[from_id]);
+	auto from_z = _mm512_set1_pd(z[from_id]);
+
+	auto j = begin;
+	for (; j + 8 <= end; j += 8)
+	{
+		auto dx = _mm512_sub_pd(from_x, _mm512_loadu_pd(x + j));
+		auto dy = _mm512_sub_pd(from_y, _mm512_loadu_pd(y + j));
+		auto dz = _mm512_sub_pd(from_z, _mm512_loadu_pd(z + j));
+		auto squared = _mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(dx, dx), _mm512_mul_pd(dy, dy)), _mm512_mul_pd(dz, dz));
+		_mm512_storeu_pd(distance + (j - begin), _mm512_sqrt_pd(squared));
+	}
+
+	euclidean3d_row_scalar(x, y, z, from_id, j, end, distance + (j - begin));
+}
+
+
+//early arrival term: k2 * t^2 / 2 + k1 * due * t - (k1 * ready * t + k2 * ready * t)
+SIMD_TARGET("avx2")
+static __m256d early_arrival_avx2(__m256d k2, __m256d k1_due, __m256d k1_ready, __m256d k2_ready, __m256d marked_t)
+{
+	auto square = _mm256_mul_pd(marked_t, marked_t);
+	return _mm256_sub_pd(
+		_mm256_add_pd(_mm256_div_pd(_mm256_mul_pd(k2, square), _mm256_set1_pd(2.0)), _mm256_mul_pd(k1_due, marked_t)),
+		_mm256_add_pd(_mm256_mul_pd(k1_ready, marked_t), _mm256_mul_pd(k2_ready, marked_t)));
+}
+
+//good (k = k1) and late (k = k3) arrival terms: k * -1 * t^2 / 2 + k * due * t
+SIMD_TARGET("avx2")
+static __m256d arrival_avx2(__m256d k_negative, __m256d k_due, __m256d marked_t)
+{
+	auto square = _mm256_mul_pd(marked_t, marked_t);
+	return _mm256_add_pd(_mm256_div_pd(_mm256_mul_pd(k_negative, square), _mm256_set1_pd(2.0)), _mm256_mul_pd(k_due, marked_t));
+}
+
+/*
+* vectorized temporal_scalar. Lanes compute the same operations without branches, std::min(a, b) is (b < a ? b : a)
+* and std::max(a, b) is (a < b ? b : a), that are min_pd(b, a) and max_pd(b, a) also when a and b are equal or NaN
+*/
+SIMD_TARGET("avx2")
+static __m256d temporal_avx2(__m256d from_ready, __m256d from_due, __m256d offset, __m256d to_ready, __m256d to_due, const temporal_parameters& parameters)
+{
+	auto k1 = _mm256_set1_pd(parameters.k1);
+	auto k2 = _mm256_set1_pd(parameters.k2);
+	auto k3 = _mm256_set1_pd(parameters.k3);
+	auto minus_one = _mm256_set1_pd(-1.0);
+	auto marked_ready = _mm256_add_pd(from_ready, offset);
+	auto marked_due = _mm256_add_pd(from_due, offset);
+
+	auto k1_ready = _mm256_mul_pd(k1, to_ready);
+	auto k2_ready = _mm256_mul_pd(k2, to_ready);
+	auto k1_due = _mm256_mul_pd(k1, to_due);
+	auto k3_due = _mm256_mul_pd(k3, to_due);
+	auto k1_negative = _mm256_mul_pd(k1, minus_one);
+	auto k3_negative = _mm256_mul_pd(k3, minus_one);
+
+	auto sum = _mm256_sub_pd(early_arrival_avx2(k2, k1_due, k1_ready, k2_ready, _mm256_min_pd(to_ready, marked_due)),
+		early_arrival_avx2(k2, k1_due, k1_ready, k2_ready, _mm256_min_pd(to_ready, marked_ready)));
+	sum = _mm256_add_pd(sum, arrival_avx2(k1_negative, k1_due, _mm256_max_pd(to_ready, _mm256_min_pd(to_due, marked_due))));
+	sum = _mm256_sub_pd(sum, arrival_avx2(k1_negative, k1_due, _mm256_min_pd(to_due, _mm256_max_pd(to_ready, marked_ready))));
+	sum = _mm256_add_pd(sum, arrival_avx2(k3_negative, k3_due, _mm256_max_pd(to_due, marked_due)));
+	sum = _mm256_sub_pd(sum, arrival_avx2(k3_negative, k3_due, _mm256_max_pd(to_due, marked_ready)));
+
+	return _mm256_sub_pd(_mm256_mul_pd(k1, _mm256_set1_pd(parameters.max_width)), _mm256_div_pd(sum, _mm256_sub_pd(marked_due, marked_ready)));
+}
+
+SIMD_TARGET("avx2")
+static void temporal_row_avx2(const double* ready, const double* due, const double* service, const double* travel,
+	int from_id, int begin, int end, const temporal_parameters& parameters, double* distance)
+{
+	auto from_ready = _mm256_set1_pd(ready[from_id]);
+	auto from_due = _mm256_set1_pd(due[from_id]);
+	auto from_service = _mm256_set1_pd(service[from_id]);
+
+	auto j = begin;
+	for (; j + 4 <= end; j += 4)
+	{
+		auto to_ready = _mm256_loadu_pd(ready + j);
+		auto to_due = _mm256_loadu_pd(due + j);
+		auto to_travel = _mm256_loadu_pd(travel + (j - begin));
+
+		auto forward = temporal_avx2(from_ready, from_due, _mm256_add_pd(from_service, to_travel), to_ready, to_due, parameters);
+		auto backward = temporal_avx2(to_ready, to_due, _mm256_add_pd(_mm256_loadu_pd(service + j), to_travel), from_ready, from_due, parameters);
+		_mm256_storeu_pd(distance + (j - begin), _mm256_min_pd(backward, forward));
+	}
+
+	temporal_row_scalar(ready, due, service, travel + (j - begin), from_id, j, end, parameters, distance + (j - begin));
+}
+
+//early arrival term: k2 * t^2 / 2 + k1 * due * t - (k1 * ready * t + k2 * ready * t)
+SIMD_TARGET("avx512f")
+static __m512d early_arrival_avx512(__m512d k2, __m512d k1_due, __m512d k1_ready, __m512d k2_ready, __m512d marked_t)
+{
+	auto square = _mm512_mul_pd(marked_t, marked_t);
+	return _mm512_sub_pd(
+		_mm512_add_pd(_mm512_div_pd(_mm512_mul_pd(k2, square), _mm512_set1_pd(2.0)), _mm512_mul_pd(k1_due, marked_t)),
+		_mm512_add_pd(_mm512_mul_pd(k1_ready, marked_t), _mm512_mul_pd(k2_ready, marked_t)));
+}
+
+//good (k = k1) and late (k = k3) arrival terms: k * -1 * t^2 / 2 + k * due * t
+SIMD_TARGET("avx512f")
+static __m512d arrival_avx512(__m512d k_negative, __m512d k_due, __m512d marked_t)
+{
+	auto square = _mm512_mul_pd(marked_t, marked_t);
+	return _mm512_add_pd(_mm512_div_pd(_mm512_mul_pd(k_negative, square), _mm512_set1_pd(2.0)), _mm512_mul_pd(k_due, marked_t));
+}
+
+SIMD_TARGET("avx512f")
+static __m512d temporal_avx512(__m512d from_ready, __m512d from_due, __m512d offset, __m512d to_ready, __m512d to_due, const temporal_parameters& parameters)
+{
+	auto k1 = _mm512_set1_pd(parameters.k1);
+	auto k2 = _mm512_set1_pd(parameters.k2);
+	auto k3 = _mm512_set1_pd(parameters.k3);
+	auto minus_one = _mm512_set1_pd(-1.0);
+	auto marked_ready = _mm512_add_pd(from_ready, offset);
+	auto marked_due = _mm512_add_pd(from_due, offset);
+
+	auto k1_ready = _mm512_mul_pd(k1, to_ready);
+	auto k2_ready = _mm512_mul_pd(k2, to_ready);
+	auto k1_due = _mm512_mul_pd(k1, to_due);
+	auto k3_due = _mm512_mul_pd(k3, to_due);
+	auto k1_negative = _mm512_mul_pd(k1, minus_one);
+	auto k3_negative = _mm512_mul_pd(k3, minus_one);
+
+	auto sum = _mm512_sub_pd(early_arrival_avx512(k2, k1_due, k1_ready, k2_ready, _mm512_min_pd(to_ready, marked_due)),
+		early_arrival_avx512(k2, k1_due, k1_ready, k2_ready, _mm512_min_pd(to_ready, marked_ready)));
+	sum = _mm512_add_pd(sum, arrival_avx512(k1_negative, k1_due, _mm512_max_pd(to_ready, _mm512_min_pd(to_due, marked_due))));
+	sum = _mm512_sub_pd(sum, arrival_avx512(k1_negative, k1_due, _mm512_min_pd(to_due, _mm512_max_pd(to_ready, marked_ready))));
+	sum = _mm512_add_pd(sum, arrival_avx512(k3_negative, k3_due, _mm512_max_pd(to_due, marked_due)));
+	sum = _mm512_sub_pd(sum, arrival_avx512(k3_negative, k3_due, _mm512_max_pd(to_due, marked_ready)));
+
+	return _mm512_sub_pd(_mm512_mul_pd(k1, _mm512_set1_pd(parameters.max_width)), _mm512_div_pd(sum, _mm512_sub_pd(marked_due, marked_ready)));
+}
+
+SIMD_TARGET("avx512f")
+static void temporal_row_avx512(const double* ready, const double* due, const double* service, const double* travel,
+	int from_id, int begin, int end, const temporal_parameters& parameters, double* distance)
+{
+	auto from_ready = _mm512_set1_pd(ready[from_id]);
+	auto from_due = _mm512_set1_pd(due[from_id]);
+	auto from_service = _mm512_set1_pd(service[from_id]);
+
+	auto j = begin;
+	for (; j + 8 <= end; j += 8)
+	{
+		auto to_ready = _mm512_loadu_pd(ready + j);
+		auto to_due = _mm512_loadu_pd(due + j);
+		auto to_travel = _mm512_loadu_pd(travel + (j - begin));
+
+		auto forward = temporal_avx512(from_ready, from_due, _mm512_add_pd(from_service, to_travel), to_ready, to_due, parameters);
+		auto backward = temporal_avx512(to_ready, to_due, _mm512_add_pd(_mm512_loadu_pd(service + j), to_travel), from_ready, from_due, parameters);
+		_mm512_storeu_pd(distance + (j - begin), _mm512_min_pd(backward, forward));
+	}
+
+	temporal_row_scalar(ready, due, service, travel + (j - begin), from_id, j, end, parameters, distance + (j - begin));
+}
+
+/*
+* two registers of customers at a time, so the compares of one do not wait for the other. A lane takes the value of
+* row j only if strictly less, which keeps the first row in case of ties as the scalar version. Positions are kept
+* as doubles (exact for any k) and converted when stored
+*/
+SIMD_TARGET("avx2")
+static double nearest_rows_avx2(const double* rows, int k, std::size_t stride, int count, double* nearest, int* label, double total)
+{
+	double min[8];
+
+	auto i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		auto min_low = _mm256_loadu_pd(rows + i);
+		auto min_high = _mm256_loadu_pd(rows + i + 4);
+		auto label_low = _mm256_setzero_pd();
+		auto label_high = _mm256_setzero_pd();
+
+		for (auto j = 1; j < k; j++)
+		{
+			auto row = rows + j * stride + i;
+			auto value_low = _mm256_loadu_pd(row);
+			auto value_high = _mm256_loadu_pd(row + 4);
+
+			if (label != nullptr)
+			{
+				auto position = _mm256_set1_pd(double(j));
+				label_low = _mm256_blendv_pd(label_low, position, _mm256_cmp_pd(value_low, min_low, _CMP_LT_OQ));
+				label_high = _mm256_blendv_pd(label_high, position, _mm256_cmp_pd(value_high, min_high, _CMP_LT_OQ));
+			}
+			min_low = _mm256_min_pd(value_low, min_low);
+			min_high = _mm256_min_pd(value_high, min_high);
+		}
+
+		_mm256_storeu_pd(min, min_low);
+		_mm256_storeu_pd(min + 4, min_high);
+		if (nearest != nullptr)
+		{
+			_mm256_storeu_pd(nearest + i, min_low);
+			_mm256_storeu_pd(nearest + i + 4, min_high);
+		}
+		if (label != nullptr)
+		{
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(label + i), _mm256_cvtpd_epi32(label_low));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(label + i + 4), _mm256_cvtpd_epi32(label_high));
+		}
+
+		//the sum is not vectorized, it must add the values in the same order of the scalar version
+		for (auto lane = 0; lane < 8; lane++)
+		{
+			total += min[lane];
+		}
+	}
+
+	return nearest_rows_scalar(rows + i, k, stride, count - i, nearest ? nearest + i : nullptr, label ? label + i : nullptr, total);
+}
+
+SIMD_TARGET("avx512f")
+static double nearest_rows_avx512(const double* rows, int k, std::size_t stride, int count, double* nearest, int* label, double total)
+{
+	double min[16];
+
+	auto i = 0;
+	for (; i + 16 <= count; i += 16)
+	{
+		auto min_low = _mm512_loadu_pd(rows + i);
+		auto min_high = _mm512_loadu_pd(rows + i + 8);
+		auto label_low = _mm512_setzero_pd();
+		auto label_high = _mm512_setzero_pd();
+
+		for (auto j = 1; j < k; j++)
+		{
+			auto row = rows + j * stride + i;
+			auto value_low = _mm512_loadu_pd(row);
+			auto value_high = _mm512_loadu_pd(row + 8);
+
+			if (label != nullptr)
+			{
+				auto position = _mm512_set1_pd(double(j));
+				label_low = _mm512_mask_mov_pd(label_low, _mm512_cmp_pd_mask(value_low, min_low, _CMP_LT_OQ), position);
+				label_high = _mm512_mask_mov_pd(label_high, _mm512_cmp_pd_mask(value_high, min_high, _CMP_LT_OQ), position);
+			}
+			min_low = _mm512_min_pd(value_low, min_low);
+			min_high = _mm512_min_pd(value_high, min_high);
+		}
+
+		_mm512_storeu_pd(min, min_low);
+		_mm512_storeu_pd(min + 8, min_high);
+		if (nearest != nullptr)
+		{
+			_mm512_storeu_pd(nearest + i, min_low);
+			_mm512_storeu_pd(nearest + i + 8, min_high);
+		}
+		if (label != nullptr)
+		{
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(label + i), _mm512_cvtpd_epi32(label_low));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(label + i + 8), _mm512_cvtpd_epi32(label_high));
+		}
+
+		for (auto lane = 0; lane < 16; lane++)
+		{
+			total += min[lane];
+		}
+	}
+
+	return nearest_rows_scalar(rows + i, k, stride, count - i, nearest ? nearest + i : nullptr, label ? label + i : nullptr, total);
+}
+
+#endif
+
+void euclidean_row(const double* x, const double* y, int from_id, int begin, int end, double* distance, int* time)
+{
+#if SIMD_X86
+	switch (active_simd_level())
+	{
+	case simd_level::avx512:
+		return euclidean_row_avx512(x, y, from_id, begin, end, distance, time);
+	case simd_level::avx2:
+		return euclidean_row_avx2(x, y, from_id, begin, end, distance, time);
+	default:
+		break;
+	}
+#endif
+	euclidean_row_scalar(x, y, from_id, begin, end, distance, time);
+}
+
+void euclidean3d_row(const double* x, const double* y, const double* z, int from_id, int begin, int end, double* distance)
+{
+#if SIMD_X86
+	switch (active_simd_level())
+	{
+	case simd_level::avx512:
+		return euclidean3d_row_avx512(x, y, z, from_id, begin, end, distance);
+	case simd_level::avx2:
+		return euclidean3d_row_avx2(x, y, z, from_id, begin, end, distance);
+	default:
+		break;
+	}
+#endif
+	euclidean3d_row_scalar(x, y, z, from_id, begin, end, distance);
+}
+
+void temporal_row(const double* ready, const double* due, const double* service, const double* travel,
+	int from_id, int begin, int end, const temporal_parameters& parameters, double* distance)
+{
+#if SIMD_X86
+	switch (active_simd_level())
+	{
+	case simd_level::avx512:
+		return temporal_row_avx512(ready, due, service, travel, from_id, begin, end, parameters, distance);
+	case simd_level::avx2:
+		return temporal_row_avx2(ready, due, service, travel, from_id, begin, end, parameters, distance);
+	default:
+		break;
+	}
+#endif
+	temporal_row_scalar(ready, due, service, travel, from_id, begin, end, parameters, distance);
+}
+
+double temporal_pair(const double* ready, const double* due, const double* service, double travel,
+	int from_id, int to_id, const temporal_parameters& parameters)
+{
+	double distance;
+	temporal_row_scalar(ready, due, service, &travel, from_id, to_id, to_id + 1, parameters, &distance);
+	return distance;
+}
+
+double nearest_rows(const double* rows, int k, std::size_t stride, int count, double* nearest, int* label, double total)
+{
+#if SIMD_X86
+	switch (active_simd_level())
+	{
+	case simd_level::avx512:
+		return nearest_rows_avx512(rows, k, stride, count, nearest, label, total);
+	case simd_level::avx2:
+		return nearest_rows_avx2(rows, k, stride, count, nearest, label, total);
+	default:
+		break;
+	}
+#endif
+	return nearest_rows_scalar(rows, k, stride, count, nearest, label, total);
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include <cstddef>
+
+/**
+* batch kernels that compute a row of distances at once from coordinates stored as
+* structure of arrays (one array per axis).
+*
+* Every kernel has a scalar, an AVX2 and an AVX-512 implementation, the one given by
+* active_simd_level() is used (see CpuFeatures.h). All implementations give the same
+* results of the scalar one.
+*
+*/
+
+/**
+* Euclidean distances between customer from_id and customers in [begin; end)
+*
+* input:
+* x, y: coordinates of all customers
+* from_id: customer id
+* begin, end: interval of customer ids
+* distance: receives end - begin distances, can be nullptr
+* time: receives end - begin travel times as used by OrTools, int(sqrt(distance^2 + 0.5)), can be nullptr
+*
+*/
+void euclidean_row(const double* x, const double* y, int from_id, int begin, int end, double* distance, int* time);
+
+/**
+* Euclidean distances in 3 dimensions between customer from_id and customers in [begin; end)
+*
+* input:
+* x, y, z: coordinates of all customers
+* from_id: customer id
+* begin, end: interval of customer ids
+* distance: receives end - begin distances
+*
+*/
+void euclidean3d_row(const double* x, const double* y, const double* z, int from_id, int begin, int end, double* distance);
+
+/**
+* parameters of the temporal distance (see SpatioTemporal)
+*
+* k1, k2, k3: multipliers of good, early and late arrival
+* max_width: max time window width
+*
+*/
+struct temporal_parameters
+{
+	double k1;
+	double k2;
+	double k3;
+	double max_width;
+};
+
+/**
+* temporal distances between customer from_id and customers in [begin; end).
+* The distance is not symmetric, the smaller of the two directions is used as in SpatioTemporal
+*
+* input:
+* ready, due: time windows of all customers
+* service: service times of all customers
+* travel: end - begin travel times from customer from_id to customers in [begin; end)
+* from_id: customer id
+* begin, end: interval of customer ids
+* parameters: multipliers and max time window width
+* distance: receives end - begin values min(temporal(from_id, j), temporal(j, from_id))
+*
+*/
+void temporal_row(const double* ready, const double* due, const double* service, const double* travel,
+	int from_id, int begin, int end, const temporal_parameters& parameters, double* distance);
+
+/**
+* temporal distance of a single pair, same value given by temporal_row
+*
+* input:
+* ready, due, service: time windows and service times of all customers
+* travel: travel time between the two customers
+* from_id, to_id: customer ids
+* parameters: multipliers and max time window width
+*
+*/
+double temporal_pair(const double* ready, const double* due, const double* service, double travel,
+	int from_id, int to_id, const temporal_parameters& parameters);
+
+/**
+* nearest of k rows for every column: rows are stored medoid-major, a row of distances for each medoid,
+* so every customer is compared with the k medoids by reading k contiguous streams
+*
+* input:
+* rows: k rows, row j starts at rows + j * stride
+* k: number of rows, at least one
+* stride: distance between the starts of two consecutive rows
+* count: number of columns of each row
+* nearest: receives count minimum values, can be nullptr
+* label: receives count row positions of the minimum values, the first one in case of ties, can be nullptr
+* total: value the minimum values are added to, one at a time in order of column
+*
+* output:
+* total plus the count minimum values
+*
+*/
+double nearest_rows(const double* rows, int k, std::size_t stride, int count, double* nearest, int* label, double total = 0.0);
@@ -0,0 +1,138 @@
+#include "DistanceMatrix.h"
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+template<class T>
+DistanceMatrix<T>::DistanceMatrix(int size, matrix_layout layout)
+{
+	this->allocate(size, layout);
+}
+
+template<class T>
+DistanceMatrix<T>::DistanceMatrix(const T* values, int size, matrix_layout layout, std::shared_ptr<const void> owner)
+{
+	this->values = values;
+	this->size = size;
+	this->layout = layout;
+	this->owner = std::move(owner);
+}
+
+template<class T>
+DistanceMatrix<T>::DistanceMatrix(const DistanceMatrix& other)
+{
+	*this = other;
+}
+
+template<class T>
+DistanceMatrix<T>& DistanceMatrix<T>::operator=(const DistanceMatrix& other)
+{
+	if (this == &other)
+		return *this;
+
+	//borrowed values are shared, owned values are copied
+	if (other.is_borrowed())
+	{
+		this->storage.reset();
+		this->values = other.values;
+		this->size = other.size;
+		this->layout = other.layout;
+		this->owner = other.owner;
+	}
+	else
+	{
+		this->allocate(other.size, other.layout);
+		std::copy(other.values, other.values + other.count(), this->storage.get());
+	}
+
+	return *this;
+}
+
+template<class T>
+DistanceMatrix<T>::DistanceMatrix(DistanceMatrix&& other) noexcept
+{
+	*this = std::move(other);
+}
+
+template<class T>
+DistanceMatrix<T>& DistanceMatrix<T>::operator=(DistanceMatrix&& other) noexcept
+{
+	if (this != &other)
+	{
+		this->storage = std::move(other.storage);
+		this->owner = std::move(other.owner);
+		this->values = std::exchange(other.values, nullptr);
+		this->size = std::exchange(other.size, 0);
+		this->layout = other.layout;
+	}
+	return *this;
+}
+
+template<class T>
+void DistanceMatrix<T>::resize(int size, matrix_layout layout)
+{
+	this->allocate(size, layout);
+}
+
+template<class T>
+void DistanceMatrix<T>::allocate(int size, matrix_layout layout)
+{
+	this->owner.reset();
+	this->storage.reset();
+	this->size = size;
+	this->layout = layout;
+
+	auto n = count(size, layout);
+	if (n == 0)
+	{
+		this->values = nullptr;
+		return;
+	}
+
+	this->storage.reset(static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignment))));
+	std::fill(this->storage.get(), this->storage.get() + n, T());
+	this->values = this->storage.get();
+}
+
+template<class T>
+const T* DistanceMatrix<T>::data() const
+{
+	return this->values;
+}
+
+template<class T>
+std::size_t DistanceMatrix<T>::count() const
+{
+	return count(this->size, this->layout);
+}
+
+template<class T>
+std::size_t DistanceMatrix<T>::bytes() const
+{
+	return this->count() * sizeof(T);
+}
+
+template<class T>
+int DistanceMatrix<T>::get_size() const
+{
+	return this->size;
+}
+
+template<class T>
+matrix_layout DistanceMatrix<T>::get_layout() const
+{
+	return this->layout;
+}
+
+template<class T>
+bool DistanceMatrix<T>::is_borrowed() const
+{
+	return this->values != nullptr && this->storage == nullptr;
+}
+
+template<class T>
+std::size_t DistanceMatrix<T>::count(int size, matrix_layout layout)
+{
+	std::size_t n = size;
+	return layout == matrix_layout::full ? n * n : n * (n + 1) / 2;
+}
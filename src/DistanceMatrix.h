@@ -0,0 +1,183 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <new>
+
+//layouts available for a DistanceMatrix
+enum class matrix_layout
+{
+	//size x size values, row-major
+	full,
+
+	//upper triangle with main diagonal, row-major. Only for symmetric matrices, it needs about half of the memory
+	packed
+};
+
+/**
+* square matrix of distances between customers stored in a single 64 bytes aligned block
+*
+* The matrix either owns its values or borrows them from memory owned by someone else
+* (e.g. a mapped NodesSnapshot). Borrowed matrices are read-only.
+*
+*/
+template<class T>
+class DistanceMatrix
+{
+public:
+	DistanceMatrix() = default;
+
+	/**
+	* constructor of an owned matrix, values are set to 0
+	*
+	* input:
+	* size: number of rows and columns
+	* layout: full or packed (symmetric matrices only)
+	*
+	*/
+	DistanceMatrix(int size, matrix_layout layout = matrix_layout::full);
+
+	/**
+	* constructor of a borrowed matrix
+	*
+	* input:
+	* values: first value of a matrix stored with the given layout
+	* size: number of rows and columns
+	* layout: layout of values
+	* owner: optional object that keeps values alive, shared by all copies of the matrix
+	*
+	*/
+	DistanceMatrix(const T* values, int size, matrix_layout layout, std::shared_ptr<const void> owner = nullptr);
+
+	DistanceMatrix(const DistanceMatrix& other);
+	DistanceMatrix& operator=(const DistanceMatrix& other);
+	DistanceMatrix(DistanceMatrix&& other) noexcept;
+	DistanceMatrix& operator=(DistanceMatrix&& other) noexcept;
+
+	//discards the actual values and allocates an owned matrix with values set to 0
+	void resize(int size, matrix_layout layout = matrix_layout::full);
+
+	/**
+	* value of the matrix
+	*
+	* input:
+	* from_id: row
+	* to_id: column
+	*
+	* output:
+	* value in [from_id][to_id]
+	*
+	*/
+	T get(int from_id, int to_id) const
+	{
+		return this->values[this->index(from_id, to_id)];
+	}
+
+	/**
+	* sets a value of an owned matrix. In a packed matrix [to_id][from_id] changes too
+	*
+	* input:
+	* from_id: row
+	* to_id: column
+	* value: new value
+	*
+	*/
+	void set(int from_id, int to_id, T value)
+	{
+		this->storage.get()[this->index(from_id, to_id)] = value;
+	}
+
+	//sets both [from_id][to_id] and [to_id][from_id] of an owned matrix
+	void set_symmetric(int from_id, int to_id, T value)
+	{
+		this->set(from_id, to_id, value);
+		if (this->layout == matrix_layout::full)
+			this->set(to_id, from_id, value);
+	}
+
+	/**
+	* contiguous row of a full matrix
+	*
+	* output:
+	* pointer to [from_id][0], size values follow
+	*
+	*/
+	const T* row(int from_id) const
+	{
+		return this->values + std::size_t(from_id) * this->size;
+	}
+
+	T* row(int from_id)
+	{
+		return this->storage.get() + std::size_t(from_id) * this->size;
+	}
+
+	/**
+	* contiguous upper part of a row, available with every layout
+	*
+	* output:
+	* pointer to [from_id][from_id], size - from_id values follow
+	*
+	*/
+	const T* upper_row(int from_id) const
+	{
+		return this->values + this->index(from_id, from_id);
+	}
+
+	T* upper_row(int from_id)
+	{
+		return this->storage.get() + this->index(from_id, from_id);
+	}
+
+	//first stored value, values are stored as described by get_layout()
+	const T* data() const;
+
+	//number of stored values
+	std::size_t count() const;
+
+	//memory used by the values in bytes
+	std::size_t bytes() const;
+
+	int get_size() const;
+
+	matrix_layout get_layout() const;
+
+	//true if values are not owned by the matrix
+	bool is_borrowed() const;
+
+	//number of values stored for a size x size matrix with the given layout
+	static std::size_t count(int size, matrix_layout layout);
+
+private:
+	//values are aligned to a cache line
+	static const std::size_t alignment = 64;
+
+	struct aligned_delete
+	{
+		void operator()(T* values) const
+		{
+			::operator delete(values, std::align_val_t(alignment));
+		}
+	};
+
+	std::size_t index(int from_id, int to_id) const
+	{
+		if (this->layout == matrix_layout::full)
+			return std::size_t(from_id) * this->size + to_id;
+
+		//packed: row i of the upper triangle starts after the i previous rows of length size, size - 1, ...
+		std::size_t i = from_id < to_id ? from_id : to_id;
+		std::size_t j = from_id < to_id ? to_id : from_id;
+		return i * this->size - i * (i - 1) / 2 + (j - i);
+	}
+
+	void allocate(int size, matrix_layout layout);
+
+	std::unique_ptr<T[], aligned_delete> storage;
+	const T* values = nullptr;
+	std::shared_ptr<const void> owner;
+	int size = 0;
+	matrix_layout layout = matrix_layout::full;
+};
+
+//needed because otherwise the template is not usable in the header file
+#include "DistanceMatrix.cpp"
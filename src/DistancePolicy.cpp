@@ -0,0 +1,172 @@
+#include "DistancePolicy.h"
+
+//function called with a StoredDistance over the values of matrix, owned by owner
+template<class Function>
+decltype(auto) visit_stored(NodesDistance& owner, const PrecisionMatrix& matrix, Function& function)
+{
+	return matrix.visit([&owner, &function](const auto& values) -> decltype(auto)
+	{
+		StoredDistance<typename std::decay_t<decltype(values)>::value_type> policy(owner, values);
+		return function(policy);
+	});
+}
+
+template<class Function>
+decltype(auto) visit_distance(NodesDistance& distance, Function&& function)
+{
+	//derived classes are checked before their base classes, the precision of the matrices is checked once here
+	if (auto spatio_temporal = dynamic_cast<SpatioTemporal*>(&distance))
+		return visit_stored(*spatio_temporal, spatio_temporal->get_spatio_temporal_matrix(), function);
+	if (auto spatial3d = dynamic_cast<Spatial3d*>(&distance))
+		return visit_stored(*spatial3d, spatial3d->get_spatial3d_matrix(), function);
+	if (auto alpha_view = dynamic_cast<AlphaView*>(&distance))
+		return alpha_view->visit(function);
+	if (auto on_demand = dynamic_cast<OnDemandSpatioTemporal*>(&distance))
+		return function(*on_demand);
+	if (auto road = dynamic_cast<RoadDistance*>(&distance))
+		return function(*road);
+	if (auto spatial = dynamic_cast<Spatial*>(&distance))
+		return visit_stored(*spatial, spatial->get_spatial_matrix(), function);
+	return function(distance);
+}
+
+template<class Distance>
+int nearest_medoid(Distance& distance, const std::vector<int>& medoids, int customer, double& min_distance)
+{
+	int nearest = 0;
+	min_distance = distance.distance(medoids[0], customer);
+
+	for (int j = 1; j < medoids.size(); j++)
+	{
+		auto temp_distance = distance.distance(medoids[j], customer);
+		if (temp_distance < min_distance)
+		{
+			min_distance = temp_distance;
+			nearest = j;
+		}
+	}
+
+	return nearest;
+}
+
+template<class Distance>
+int nearest_medoid(Distance& distance, const std::vector<int>& medoids, const std::vector<int>& medoid_position, int customer, double& min_distance)
+{
+	//a medoid is not in its own list, duplicated customers may also be at distance 0
+	if (!distance.has_neighbours() || medoid_position[customer] >= 0)
+		return nearest_medoid(distance, medoids, customer, min_distance);
+
+	auto count = distance.neighbour_count(customer);
+	auto id = distance.neighbours(customer);
+	auto value = distance.neighbour_distances(customer);
+
+	for (auto k = 0; k < count; k++)
+	{
+		if (medoid_position[id[k]] < 0)
+			continue;
+
+		//among medoids at the same distance the full scan keeps the first one
+		auto nearest = medoid_position[id[k]];
+		auto last = k + 1;
+		for (; last < count && value[last] == value[k]; last++)
+		{
+			if (medoid_position[id[last]] >= 0)
+				nearest = std::min(nearest, medoid_position[id[last]]);
+		}
+
+		if (last == count)
+			break;
+
+		min_distance = value[k];
+		return nearest;
+	}
+
+	return nearest_medoid(distance, medoids, customer, min_distance);
+}
+
+template<class Distance>
+void gather_row(Distance& distance, int from_id, int begin, int end, double* values)
+{
+	if constexpr (has_distance_row<Distance>::value)
+	{
+		distance.distance_row(from_id, begin, end, values);
+	}
+	else
+	{
+		for (auto i = begin; i < end; i++)
+		{
+			values[i - begin] = distance.distance(from_id, i);
+		}
+	}
+}
+
+template<class Distance>
+double nearest_medoids(Distance& distance, const std::vector<int>& medoids, std::vector<double>& rows, double* nearest, int* label)
+{
+	//customers of a block, the k rows of a block stay in cache while they are reduced
+	const int block_size = 1024;
+
+	auto size = distance.get_size();
+	auto k = int(medoids.size());
+	auto block = std::min(block_size, size - 1);
+	double total = 0.0;
+	if (block <= 0)
+		return total;
+
+	rows.resize(std::size_t(k) * block);
+	for (auto begin = 1; begin < size; begin += block)
+	{
+		auto end = std::min(begin + block, size);
+		for (auto j = 0; j < k; j++)
+		{
+			gather_row(distance, medoids[j], begin, end, rows.data() + std::size_t(j) * block);
+		}
+
+		total = nearest_rows(rows.data(), k, block, end - begin, nearest ? nearest + begin : nullptr, label ? label + begin : nullptr, total);
+	}
+
+	return total;
+}
+
+template<class Distance>
+double nearest_medoids(Distance& distance, const std::vector<int>& medoids, const std::vector<int>& medoid_position, std::vector<double>& rows, double* nearest, int* label)
+{
+	if (!distance.has_neighbours())
+		return nearest_medoids(distance, medoids, rows, nearest, label);
+
+	double total = 0.0;
+	for (auto i = 1; i < distance.get_size(); i++)
+	{
+		double min_distance;
+		auto position = nearest_medoid(distance, medoids, medoid_position, i, min_distance);
+
+		if (nearest != nullptr)
+			nearest[i] = min_distance;
+		if (label != nullptr)
+			label[i] = position;
+		total += min_distance;
+	}
+
+	return total;
+}
+
+inline void medoid_positions(const std::vector<int>& medoids, int size, std::vector<int>& medoid_position)
+{
+	medoid_position.assign(size, -1);
+	//first position of repeated medoids, as the full scan
+	for (int j = int(medoids.size()) - 1; j >= 0; j--)
+	{
+		medoid_position[medoids[j]] = j;
+	}
+}
+
+template<class Distance>
+double group_distance(Distance& distance, int customer, const std::vector<int>& group)
+{
+	double acc_distance = 0;
+	for (auto i = 0; i < group.size(); i++)
+	{
+		acc_distance += distance.distance(customer, group[i]);
+	}
+	return acc_distance;
+}
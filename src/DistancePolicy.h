@@ -0,0 +1,167 @@
+#pragma once
+#include "NodesDistance.h"
+#include "Spatial.h"
+#include "SpatioTemporal.h"
+#include "Spatial3d.h"
+#include "AlphaView.h"
+#include "OnDemandSpatioTemporal.h"
+#include "RoadDistance.h"
+#include "DistanceKernels.h"
+#include "StoredDistance.h"
+#include <algorithm>
+#include <vector>
+#include <type_traits>
+#include <utility>
+
+/**
+* compile-time distance policies
+*
+* A distance policy is any class with the member functions
+*	double distance(int from_id, int to_id)
+*	int get_size()
+* Spatial, SpatioTemporal and Spatial3d are visited as StoredDistance, with the precision of their matrix as part of the type,
+* an AlphaView as StoredDistance or FusedDistance (see AlphaView::visit). OnDemandSpatioTemporal and RoadDistance are
+* concrete policies themselves. Their distance is not virtual and is inlined in the loops below.
+* NodesDistance is the fallback policy, its distance calls get_distance.
+*
+* Partitioners keep a NodesDistance& chosen at runtime and use visit_distance around their innermost
+* loops, so each loop is compiled once for every concrete policy.
+*
+*/
+
+/**
+* true when a policy also computes many distances at once with
+*	void distance_row(int from_id, int begin, int end, double* distance) const
+* (e.g. OnDemandSpatioTemporal, whose single distances are not read from a matrix)
+*
+*/
+template<class Distance, class = void>
+struct has_distance_row : std::false_type
+{
+};
+
+template<class Distance>
+struct has_distance_row<Distance, std::void_t<decltype(std::declval<const Distance&>().distance_row(0, 0, 0, static_cast<double*>(nullptr)))>> : std::true_type
+{
+};
+
+/**
+* calls function with the most derived known type of distance
+*
+* input:
+* distance: reference to an instance of NodesDistance
+* function: callable as function(Policy& distance) for every policy
+*
+* output:
+* value returned by function
+*
+*/
+template<class Function>
+decltype(auto) visit_distance(NodesDistance& distance, Function&& function);
+
+/**
+* nearest medoid of a customer
+*
+* input:
+* distance: distance policy
+* medoids: customer ids of the medoids, at least one
+* customer: customer id
+* min_distance: receives the distance between the customer and its nearest medoid
+*
+* output:
+* position in medoids of the nearest medoid, the first one in case of ties
+*
+*/
+template<class Distance>
+int nearest_medoid(Distance& distance, const std::vector<int>& medoids, int customer, double& min_distance);
+
+/**
+* nearest medoid of a customer read from its neighbour list (see NodesDistance::build_neighbours),
+* same result of the version above. The first medoid in the list is the nearest one, all the medoids are
+* scanned only when the list has none or when its ties may continue after the list.
+* With k random medoids among n customers and lists of L neighbours about 1 - (1 - k/n)^L of the customers are
+* found in the list. Measured on C110_1 and R110_1 (n = 1000): L = 16 finds 54% with k = 50 and 97% with k = 200,
+* L = 32 finds 80% with k = 50 and 96% with k = 100. The lists are faster than the scan from about k * L = n
+* (k = 50, L = 16: 150 us instead of 170 us for all the customers) and slower below it (k = 10: 80 us instead of 60 us)
+*
+* input:
+* distance: distance policy
+* medoids: customer ids of the medoids, at least one
+* medoid_position: position in medoids of every customer, -1 for the customers that are not medoids
+* customer: customer id
+* min_distance: receives the distance between the customer and its nearest medoid
+*
+* output:
+* position in medoids of the nearest medoid, the first one in case of ties
+*
+*/
+template<class Distance>
+int nearest_medoid(Distance& distance, const std::vector<int>& medoids, const std::vector<int>& medoid_position, int customer, double& min_distance);
+
+/**
+* distances between customer from_id and customers in [begin; end), a whole row at a time with the policies
+* that have distance_row, one at a time with the others
+*
+* input:
+* distance: distance policy
+* from_id: customer id
+* begin, end: interval of customer ids
+* values: receives end - begin distances
+*
+*/
+template<class Distance>
+void gather_row(Distance& distance, int from_id, int begin, int end, double* values);
+
+/**
+* nearest medoid of every customer, with the same results of nearest_medoid. The rows of the medoids are gathered,
+* a block of customers at a time, in a contiguous medoid-major buffer and reduced by nearest_rows (see DistanceKernels.h)
+*
+* input:
+* distance: distance policy
+* medoids: customer ids of the medoids, at least one
+* rows: scratch buffer, reused between calls
+* nearest: receives in nearest[i] the distance between customer i and its nearest medoid for i in [1; get_size()), can be nullptr
+* label: receives in label[i] the position in medoids of the nearest medoid of customer i, as nearest, can be nullptr
+*
+* output:
+* sum of the distances between the customers and their nearest medoids, added in order of customer id
+*
+*/
+template<class Distance>
+double nearest_medoids(Distance& distance, const std::vector<int>& medoids, std::vector<double>& rows, double* nearest, int* label);
+
+/**
+* same as above, every customer is read from its neighbour list when the lists are built (see nearest_medoid)
+*
+* input:
+* medoid_position: position in medoids of every customer, -1 for the customers that are not medoids
+*
+*/
+template<class Distance>
+double nearest_medoids(Distance& distance, const std::vector<int>& medoids, const std::vector<int>& medoid_position, std::vector<double>& rows, double* nearest, int* label);
+
+/**
+* position in medoids of every customer, as needed by nearest_medoid
+*
+* input:
+* medoids: customer ids of the medoids
+* size: number of customers + depot
+* medoid_position: receives size positions, -1 for the customers that are not medoids
+*
+*/
+inline void medoid_positions(const std::vector<int>& medoids, int size, std::vector<int>& medoid_position);
+
+/**
+* sum of distances between a customer and every member of a group
+*
+* input:
+* distance: distance policy
+* customer: customer id
+* group: customer ids of the group
+*
+*/
+template<class Distance>
+double group_distance(Distance& distance, int customer, const std::vector<int>& group);
+
+//needed because otherwise the template is not usable in the header file
+#include "DistancePolicy.cpp"
@@ -0,0 +1,96 @@
+#include "FitnessCache.h"
+#include "ContentHash.h"
+#include <algorithm>
+
+FitnessCache::FitnessCache(std::size_t capacity, int shards) : shards(shards > 0 ? shards : 1)
+{
+	//at least one slot in every shard
+	auto slots = std::max<std::size_t>(1, (capacity + this->shards.size() - 1) / this->shards.size());
+	for (auto& part : this->shards)
+	{
+		part.slots.resize(slots);
+	}
+}
+
+void FitnessCache::make_key(const std::vector<int>& medoids, fitness_key& key)
+{
+	key.medoids.assign(medoids.begin(), medoids.end());
+	std::sort(key.medoids.begin(), key.medoids.end());
+	key.hash = content_hash(key.medoids.data(), key.medoids.size() * sizeof(int));
+}
+
+bool FitnessCache::find(const fitness_key& key, double& fitness)
+{
+	this->lookups.fetch_add(1, std::memory_order_relaxed);
+
+	auto& part = this->shard_of(key.hash);
+	std::lock_guard<std::mutex> lock(part.mutex);
+	auto& slot = this->slot_of(part, key.hash);
+
+	if (!slot.used || slot.hash != key.hash || slot.medoids != key.medoids)
+		return false;
+
+	this->hits.fetch_add(1, std::memory_order_relaxed);
+	fitness = slot.fitness;
+	return true;
+}
+
+void FitnessCache::insert(const fitness_key& key, double fitness)
+{
+	this->insertions.fetch_add(1, std::memory_order_relaxed);
+
+	auto& part = this->shard_of(key.hash);
+	std::lock_guard<std::mutex> lock(part.mutex);
+	auto& slot = this->slot_of(part, key.hash);
+
+	if (slot.used && (slot.hash != key.hash || slot.medoids != key.medoids))
+		this->evictions.fetch_add(1, std::memory_order_relaxed);
+
+	slot.used = true;
+	slot.hash = key.hash;
+	slot.medoids.assign(key.medoids.begin(), key.medoids.end());
+	slot.fitness = fitness;
+}
+
+void FitnessCache::clear()
+{
+	for (auto& part : this->shards)
+	{
+		std::lock_guard<std::mutex> lock(part.mutex);
+		for (auto& slot : part.slots)
+		{
+			slot.used = false;
+		}
+	}
+
+	this->lookups = 0;
+	this->hits = 0;
+	this->insertions = 0;
+	this->evictions = 0;
+}
+
+fitness_cache_stats FitnessCache::get_stats() const
+{
+	fitness_cache_stats stats;
+	stats.lookups = this->lookups.load(std::memory_order_relaxed);
+	stats.hits = this->hits.load(std::memory_order_relaxed);
+	stats.insertions = this->insertions.load(std::memory_order_relaxed);
+	stats.evictions = this->evictions.load(std::memory_order_relaxed);
+	return stats;
+}
+
+std::size_t FitnessCache::get_capacity() const
+{
+	return this->shards.size() * this->shards[0].slots.size();
+}
+
+FitnessCache::shard& FitnessCache::shard_of(std::uint64_t hash)
+{
+	return this->shards[hash % this->shards.size()];
+}
+
+FitnessCache::entry& FitnessCache::slot_of(shard& part, std::uint64_t hash)
+{
+	//the low bits choose the shard, the other ones the slot
+	return part.slots[(hash / this->shards.size()) % part.slots.size()];
+}
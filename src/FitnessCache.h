@@ -0,0 +1,120 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+/**
+* canonical key of a set of medoids: the medoids sorted and their hash, the order of a chromosome does not matter
+*
+*/
+struct fitness_key
+{
+	std::uint64_t hash = 0;
+	std::vector<int> medoids;
+};
+
+/**
+* counters of a FitnessCache since its construction or the last clear
+*
+* lookups: calls of find
+* hits: calls of find that found the fitness
+* insertions: calls of insert
+* evictions: insertions that replaced the fitness of another set of medoids
+*
+*/
+struct fitness_cache_stats
+{
+	long long lookups = 0;
+	long long hits = 0;
+	long long insertions = 0;
+	long long evictions = 0;
+
+	//fraction of lookups that were hits
+	double hit_rate() const
+	{
+		return this->lookups > 0 ? double(this->hits) / this->lookups : 0.0;
+	}
+};
+
+/**
+* fitness values of sets of medoids already evaluated by GeneticEvolution, shared by the threads of the evaluation
+* (and by the islands of island_part). Chromosomes that did not change since their last evaluation never get here
+* (see medoid_cache), only the sets of medoids reached again by other chromosomes or other islands are found.
+*
+* The size is bounded: entries are split in shards with their own lock, each set of medoids has one slot in its shard
+* and replaces the previous one. Keys are checked on the whole set, different sets with the same hash are never confused.
+* Values depend on the distance, a cache must be used only with one NodesDistance
+*
+*/
+class FitnessCache
+{
+public:
+	/**
+	* constructor
+	*
+	* input:
+	* capacity: maximum number of fitness values
+	* shards: number of independent parts, more shards mean less waiting between threads
+	*
+	*/
+	FitnessCache(std::size_t capacity = 8192, int shards = 16);
+
+	/**
+	* canonical key of a chromosome
+	*
+	* input:
+	* medoids: medoids of a chromosome, in any order
+	* key: reference to the to be initialized key, its vector is reused
+	*
+	*/
+	static void make_key(const std::vector<int>& medoids, fitness_key& key);
+
+	/**
+	* input:
+	* key: key of a set of medoids (see make_key)
+	* fitness: receives the fitness value if found
+	*
+	* output:
+	* true if the fitness value of the set is in the cache
+	*
+	*/
+	bool find(const fitness_key& key, double& fitness);
+
+	//stores the fitness value of the set of key, replacing the set that has the same slot
+	void insert(const fitness_key& key, double fitness);
+
+	//removes all the values and resets the counters
+	void clear();
+
+	fitness_cache_stats get_stats() const;
+
+	std::size_t get_capacity() const;
+
+private:
+	struct entry
+	{
+		bool used = false;
+		std::uint64_t hash = 0;
+		std::vector<int> medoids;
+		double fitness = 0.0;
+	};
+
+	struct shard
+	{
+		std::mutex mutex;
+		std::vector<entry> slots;
+	};
+
+	//shard and slot of a key
+	shard& shard_of(std::uint64_t hash);
+	entry& slot_of(shard& part, std::uint64_t hash);
+
+	std::vector<shard> shards;
+
+	std::atomic<long long> lookups{ 0 };
+	std::atomic<long long> hits{ 0 };
+	std::atomic<long long> insertions{ 0 };
+	std::atomic<long long> evictions{ 0 };
+};
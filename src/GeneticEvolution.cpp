@@ -1,18 +1,34 @@
 #include "GeneticEvolution.h"
 #include "ConsecutiveRandoms.h"
+#include "DistancePolicy.h"
+#include "ContentHash.h"
+#include "MigrationRing.h"
+#include "Barrier.h"
 #include <iostream>
 #include <fstream>
 #include <set>
 #include <array>
+#include <utility>
+#include <algorithm>
+#include <ctime>
+
+//steps of a generation with their own random streams (see GeneticEvolution::stream)
+static const int population_step = 0;
+static const int selection_step = 1;
+static const int pairing_step = 2;
+static const int crossover_step = 3;
+static const int mutation_step = 4;
 
 GeneticEvolution::GeneticEvolution(NodesDistance& nodes) 
 {
 	this->nodes = &nodes;
+	this->seed = std::uint64_t(std::time(0));
 };
 
 GeneticEvolution::GeneticEvolution(NodesDistance& nodes, int p_size, double crossover_p, double crossover_mutation, double candidate_mutation)
 {
 	this->nodes = &nodes;
+	this->seed = std::uint64_t(std::time(0));
 
 	if (p_size > 0)
 		this->population_size = p_size;
@@ -29,21 +45,166 @@ std::vector<std::vector<int>> GeneticEvolution::genetic_part(int groups)
 	return this->genetic_part(groups, this->number_of_generations);
 }
 
+void GeneticEvolution::set_seed(std::uint64_t seed)
+{
+	this->seed = seed;
+}
+
+void GeneticEvolution::set_workers(int workers)
+{
+	this->workers = workers;
+	this->pool = nullptr;
+}
+
+void GeneticEvolution::set_thread_pool(std::shared_ptr<ThreadPool> pool)
+{
+	this->pool = pool;
+}
+
+std::default_random_engine GeneticEvolution::stream(int generation, int step, int index)
+{
+	//the seed of a stream depends only on the seed of the run and on the task, not on the thread that runs it
+	int task[3] = { generation, step, index };
+	return std::default_random_engine(std::default_random_engine::result_type(content_hash(task, sizeof(task), this->seed)));
+}
+
 std::vector<std::vector<int>> GeneticEvolution::genetic_part(int groups, int n_generations)
 {
-	//create initial population
-	std::vector<std::vector<int>>* population = new std::vector<std::vector<int>>(this->population_size, std::vector<int>(groups, 0));
-	std::vector<double> raw_fitness(population_size, 0.0);
+	this->init_population(groups);
 
-	double best_fitness_value = 0;
-	std::vector<int> current_best_solution;
-	int best_index = 0;
+	//evolve population
+	for (auto gen = 0; gen < n_generations; gen++)
+	{
+		//generation 0 is the initial population
+		this->evolve(gen + 1);
+	}
+
+	return this->assign(this->best_solution);
+}
+
+std::vector<std::vector<int>> GeneticEvolution::island_part(int groups, int islands)
+{
+	island_settings settings;
+	settings.population_size = this->population_size;
+	settings.crossover_prob = this->crossover_prob;
+	settings.crossover_mutation = this->crossover_mutation;
+	settings.candidate_mutation = this->candidate_mutation;
+
+	return this->island_part(groups, std::vector<island_settings>(islands, settings), this->number_of_generations);
+}
+
+std::vector<std::vector<int>> GeneticEvolution::island_part(int groups, const std::vector<island_settings>& settings, int n_generations)
+{
+	auto islands = int(settings.size());
+	if (islands == 0)
+		return this->genetic_part(groups, n_generations);
+
+	//island i sends its best chromosomes to island i + 1 through ring i, no more than both populations.
+	//Every chromosome sent is received at the same migration, rings never drop chromosomes
+	std::vector<std::unique_ptr<GeneticEvolution>> island(islands);
+	std::vector<std::unique_ptr<MigrationRing>> ring(islands);
+	std::vector<int> migrants(islands);
+	for (auto i = 0; i < islands; i++)
+	{
+		island[i] = std::make_unique<GeneticEvolution>(*this->nodes, settings[i].population_size, settings[i].crossover_prob,
+			settings[i].crossover_mutation, settings[i].candidate_mutation);
+		island[i]->set_workers(1);
+
+		//all the islands use the same distance, with a fitness cache each one finds also the values computed by the others
+		island[i]->set_fitness_cache(this->memo);
+
+		int task[2] = { -1, i };
+		island[i]->set_seed(content_hash(task, sizeof(task), this->seed));
+
+		ring[i] = std::make_unique<MigrationRing>(2 * this->migrants, groups);
+		migrants[i] = std::min({ this->migrants, settings[i].population_size, settings[(i + 1) % islands].population_size });
+	}
+
+	/*
+	* one thread for each island (the pool has a worker for each task, so all the islands run together).
+	* At every migration the islands meet after sending: each one receives the chromosomes sent by the previous one in the
+	* same generation, whatever the timing of the threads, and results with a fixed seed are reproducible.
+	* A ring holds two migrations, an island can send the next ones before its receiver has read the previous ones
+	*/
+	ThreadPool threads(islands);
+	Barrier migration(islands);
+	threads.run(islands, [this, &island, &ring, &migrants, &migration, islands, groups, n_generations](int i, int worker)
+	{
+		auto& current = *island[i];
+		auto previous = (i + islands - 1) % islands;
+
+		current.init_population(groups);
+		for (auto gen = 0; gen < n_generations; gen++)
+		{
+			current.evolve(gen + 1);
+
+			if ((gen + 1) % this->migration_interval == 0)
+			{
+				current.send_migrants(*ring[i], migrants[i]);
+				migration.wait();
+				current.receive_migrants(*ring[previous], migrants[previous]);
+			}
+		}
+	});
+
+	//best chromosome of all the islands, the first one in case of ties
+	auto best = 0;
+	for (auto i = 1; i < islands; i++)
+	{
+		if (island[i]->best_fitness < island[best]->best_fitness)
+			best = i;
+	}
+
+	this->best_solution = island[best]->best_solution;
+	this->best_fitness = island[best]->best_fitness;
 
-	ConsecutiveRandoms<int> rand(1, this->nodes->get_size() - 1);
+	return this->assign(this->best_solution);
+}
+
+void GeneticEvolution::set_fitness_cache(std::shared_ptr<FitnessCache> memo)
+{
+	this->memo = memo;
+}
+
+std::shared_ptr<FitnessCache> GeneticEvolution::get_fitness_cache()
+{
+	return this->memo;
+}
+
+void GeneticEvolution::set_migration(int interval, int migrants)
+{
+	if (interval > 0)
+		this->migration_interval = interval;
+	if (migrants > 0)
+		this->migrants = migrants;
+}
+
+void GeneticEvolution::init_population(int groups)
+{
+	this->population.assign(this->population_size, std::vector<int>(groups, 0));
+	this->temp_population.assign(this->population_size, std::vector<int>(groups, 0));
+	this->raw_fitness.assign(this->population_size, 0.0);
+
+	//the threads are started once and used by every generation
+	if (this->pool == nullptr)
+		this->pool = std::make_shared<ThreadPool>(this->workers);
+
+	auto size = this->nodes->get_size();
+	this->buffers.resize(this->pool->get_workers());
+	for (auto& buffer : this->buffers)
+	{
+		buffer.marked.assign(size, 0);
+	}
+
+	this->cache.assign(this->population_size, medoid_cache());
+	this->temp_cache.assign(this->population_size, medoid_cache());
 
 	//initialize population using a support set. It assures that elements in the solution are different 
-	for (auto i = 0; i < this->population_size; i++)
+	this->pool->run(this->population_size, [this, groups, size](int i, int worker)
 	{
+		auto engine = this->stream(0, population_step, i);
+		ConsecutiveRandoms<int> rand(1, size - 1, engine);
+
 		std::set<int> temp;
 		for (auto j = 0; j < groups; )
 		{
@@ -51,110 +212,278 @@ std::vector<std::vector<int>> GeneticEvolution::genetic_part(int groups, int n_g
 			temp.insert(medoid);
 			if (temp.size() > j)
 			{
-				population->at(i).at(j) = medoid;
+				this->population[i][j] = medoid;
 				j++;
 			}
 		}
+	});
 
-		//find best first solution
-		raw_fitness[i] = fitness_value(population->at(i));
+	this->evaluate(this->population, this->raw_fitness);
 
-		if (i == 0)
-		{
-			best_fitness_value = raw_fitness[i];
+	//find best first solution
+	int best_index = 0;
+	for (auto i = 1; i < this->population_size; i++)
+	{
+		if (this->raw_fitness[i] < this->raw_fitness[best_index])
 			best_index = i;
-		}
-		else if (raw_fitness[i] < best_fitness_value)
+	}
+
+	this->best_fitness = this->raw_fitness[best_index];
+	this->best_solution = this->population[best_index];
+}
+
+void GeneticEvolution::evolve(int generation)
+{
+	auto engine = this->stream(generation, selection_step, 0);
+	roulette_selection(this->temp_population, &this->population, this->raw_fitness, engine);
+
+	crossover(this->temp_population, generation);
+
+	mutation(this->temp_population, generation);
+
+	std::swap(this->population, this->temp_population);
+	std::swap(this->cache, this->temp_cache);
+
+	//look for better candidate solution, chromosomes not changed by crossover and mutation are not evaluated again
+	this->evaluate(this->population, this->raw_fitness);
+
+	this->update_best();
+}
+
+void GeneticEvolution::update_best()
+{
+	int best_index = -1;
+	for (auto i = 0; i < this->population.size(); i++)
+	{
+		if (this->raw_fitness[i] < this->best_fitness)
 		{
-			best_fitness_value = raw_fitness[i];
+			this->best_fitness = this->raw_fitness[i];
 			best_index = i;
 		}
 	}
 
-	current_best_solution = population->at(best_index);
+	if (best_index >= 0)
+		this->best_solution = this->population[best_index];
+}
 
-	//evolve population
-	for (auto gen = 0; gen < n_generations; gen++)
+void GeneticEvolution::send_migrants(MigrationRing& ring, int migrants)
+{
+	//best chromosomes of the population, the ones that do not fit in the ring are dropped
+	std::vector<int> order(this->population.size());
+	for (auto i = 0; i < order.size(); i++)
 	{
-		auto temp_population = new std::vector<std::vector<int>>(this->population_size, std::vector<int>(groups, 0));
+		order[i] = i;
+	}
 
-		roulette_selection(*temp_population, population, raw_fitness);
+	migrants = std::min(migrants, int(order.size()));
+	std::partial_sort(order.begin(), order.begin() + migrants, order.end(), [this](int a, int b)
+	{
+		return this->raw_fitness[a] < this->raw_fitness[b] || (this->raw_fitness[a] == this->raw_fitness[b] && a < b);
+	});
 
-		crossover(*temp_population);
+	for (auto i = 0; i < migrants; i++)
+	{
+		ring.push(this->population[order[i]]);
+	}
+}
 
-		mutation(*temp_population);
+void GeneticEvolution::receive_migrants(MigrationRing& ring, int migrants)
+{
+	std::vector<int> order(this->population.size());
+	for (auto i = 0; i < order.size(); i++)
+	{
+		order[i] = i;
+	}
 
-		delete population;
-		population = temp_population;
+	//worst chromosomes first, they are replaced by the received ones
+	std::sort(order.begin(), order.end(), [this](int a, int b)
+	{
+		return this->raw_fitness[a] > this->raw_fitness[b] || (this->raw_fitness[a] == this->raw_fitness[b] && a < b);
+	});
 
-		double old_fitness_value = best_fitness_value;
+	migrants = std::min(migrants, int(order.size()));
+	for (auto i = 0; i < migrants && ring.pop(this->population[order[i]]); i++)
+	{
+		auto position = order[i];
+		this->raw_fitness[position] = this->fitness_value(this->population[position], this->cache[position], this->buffers[0]);
+	}
 
-		//look for better candidate solution
-		for (auto i = 0; i < population->size(); i++)
-		{
-			raw_fitness[i] = fitness_value(population->at(i));
+	this->update_best();
+}
 
-			if (raw_fitness[i] < best_fitness_value)
-			{
-				best_fitness_value = raw_fitness[i];
-				best_index = i;
-			}
+std::vector<std::vector<int>> GeneticEvolution::assign(const std::vector<int>& medoids)
+{
+	//create groups of the partition
+	std::vector<std::vector<int>> genetic_part(medoids.size(), std::vector<int>());
+
+	//exclude depot from each group starting with i = 1
+	visit_distance(*this->nodes, [&genetic_part, &medoids](auto& distance)
+	{
+		std::vector<int> medoid_position;
+		std::vector<double> rows;
+		std::vector<int> label(distance.get_size());
+		medoid_positions(medoids, distance.get_size(), medoid_position);
+
+		//assign each customer to the nearest medoid, with the neighbour lists when they are built
+		nearest_medoids(distance, medoids, medoid_position, rows, nullptr, label.data());
+		for (auto i = 1; i < distance.get_size(); i++)
+		{
+			genetic_part[label[i]].push_back(i);
 		}
+	});
 
-		//update best solution
-		if (best_fitness_value < old_fitness_value)
-			current_best_solution = population->at(best_index);
+	return genetic_part;
+}
 
-	}
+void GeneticEvolution::evaluate(std::vector<std::vector<int>>& population, std::vector<double>& raw)
+{
+	//chromosomes are independent, each worker has its own scratch vectors
+	this->pool->run(int(population.size()), [this, &population, &raw](int i, int worker)
+	{
+		raw[i] = this->fitness_value(population[i], this->cache[i], this->buffers[worker]);
+	});
+}
 
-	//create groups of the partition
-	std::vector<std::vector<int>> genetic_part(groups, std::vector<int>());
+double GeneticEvolution::fitness_value(const std::vector<int>& medoids, medoid_cache& cache, fitness_buffers& buffers)
+{
+	return visit_distance(*this->nodes, [this, &medoids, &cache, &buffers](auto& distance)
+	{
+		return this->fitness_value(distance, medoids, cache, buffers);
+	});
+}
 
-	//exclude depot from each group starting with i = 1
-	for (auto i = 1; i < this->nodes->get_size(); i++)
+//distances between medoid and customers [1; size) in row
+template<class Distance>
+static void medoid_row(Distance& distance, int medoid, std::vector<double>& row)
+{
+	auto size = distance.get_size();
+	row.resize(size);
+	gather_row(distance, medoid, 1, size, row.data() + 1);
+}
+
+//single distance computed as in medoid_row, so cached values do not depend on how they were found
+template<class Distance>
+static double medoid_distance(Distance& distance, int medoid, int customer)
+{
+	double value;
+	gather_row(distance, medoid, customer, customer + 1, &value);
+	return value;
+}
+
+template<class Distance>
+double GeneticEvolution::fitness_value(Distance& distance, const std::vector<int>& medoids, medoid_cache& cache, fitness_buffers& buffers)
+{
+	auto size = distance.get_size();
+	auto valid = cache.medoids.size() == medoids.size() && cache.nearest.size() == size;
+
+	if (valid)
 	{
-		int medoid = 0;
+		//medoids of the cache missing in the chromosome, and medoids of the chromosome missing in the cache
+		buffers.removed.clear();
+		buffers.added.clear();
 
-		//assign each customer to the nearest medoid. Assume that the distance from first medoid is the best. Doing so makes easier to update the best value
-		double min = this->nodes->get_distance(current_best_solution[0], i);
+		for (auto medoid : medoids)
+			buffers.marked[medoid] = 1;
+		for (int j = 0; j < cache.medoids.size(); j++)
+		{
+			if (!buffers.marked[cache.medoids[j]])
+				buffers.removed.push_back(j);
+		}
+		for (auto medoid : medoids)
+			buffers.marked[medoid] = 0;
 
-		for (auto j = 1; j < current_best_solution.size(); j++)
+		for (auto medoid : cache.medoids)
+			buffers.marked[medoid] = 1;
+		for (auto medoid : medoids)
 		{
-			auto distance = this->nodes->get_distance(current_best_solution[j], i);
-			if (distance < min)
-			{
-				min = distance;
-				medoid = j;
-			}
+			if (!buffers.marked[medoid])
+				buffers.added.push_back(medoid);
 		}
+		for (auto medoid : cache.medoids)
+			buffers.marked[medoid] = 0;
 
-		genetic_part[medoid].push_back(i);
+		//same medoids, the fitness is already known
+		if (buffers.removed.empty() && buffers.added.empty())
+			return cache.fitness;
 	}
 
-	return genetic_part;
+	//set of medoids already evaluated for another chromosome (only with a fitness cache, see set_fitness_cache).
+	//The cache of this chromosome is not updated, the values are the same whatever chromosome computed them
+	auto memo = this->memo.get();
+	if (memo != nullptr)
+	{
+		FitnessCache::make_key(medoids, buffers.key);
+		double known;
+		if (memo->find(buffers.key, known))
+			return known;
+	}
+
+	//a swap scans the customers about four times (rows of the old and of the new medoid, nearest searched again among the k
+	//medoids for the about n/k customers of the old one), a new cache k times: with many changes the cache is computed from scratch
+	if (!valid || buffers.removed.size() != buffers.added.size() || 4 * buffers.removed.size() >= medoids.size())
+	{
+		this->init_cache(distance, medoids, cache, buffers);
+	}
+	else
+	{
+		for (int j = 0; j < buffers.removed.size(); j++)
+		{
+			this->swap_medoid(distance, cache, buffers.removed[j], buffers.added[j], buffers);
+		}
+	}
+
+	//fitness value based on sum of distances of eache customer from its medoid
+	double fitness = 0.0;
+	for (auto i = 1; i < size; i++)
+	{
+		fitness += cache.nearest[i];
+	}
+	cache.fitness = fitness;
+	if (memo != nullptr)
+		memo->insert(buffers.key, fitness);
 
+	return fitness;
 }
 
-double GeneticEvolution::fitness_value(std::vector<int> medoids)
+template<class Distance>
+void GeneticEvolution::init_cache(Distance& distance, const std::vector<int>& medoids, medoid_cache& cache, fitness_buffers& buffers)
 {
-	double fitness = 0.0;
+	cache.medoids = medoids;
+	cache.nearest.resize(distance.get_size());
 
-	//fitness value based on sum of distances of eache customer from its medoid
-	for (auto i = 1; i < this->nodes->get_size(); i++)
+	//the rows of the medoids are gathered and reduced a block of customers at a time, the min is kept for each customer
+	nearest_medoids(distance, medoids, buffers.rows, cache.nearest.data(), nullptr);
+}
+
+template<class Distance>
+void GeneticEvolution::swap_medoid(Distance& distance, medoid_cache& cache, int position, int medoid, fitness_buffers& buffers)
+{
+	auto size = distance.get_size();
+	medoid_row(distance, cache.medoids[position], buffers.old_row);
+	medoid_row(distance, medoid, buffers.row);
+	cache.medoids[position] = medoid;
+
+	for (auto i = 1; i < size; i++)
 	{
-		double temp_min = this->nodes->get_distance(medoids[0], i);
-		for (int j = 1; j < medoids.size(); j++)
+		//the old medoid was the nearest one (or one of them) if it is not farther than the nearest distance
+		if (buffers.old_row[i] <= cache.nearest[i] && buffers.row[i] > cache.nearest[i])
 		{
-			temp_min = std::min(temp_min, this->nodes->get_distance(medoids[j], i));
+			//the new medoid is farther, the nearest is searched again among all the medoids
+			cache.nearest[i] = buffers.row[i];
+			for (int j = 0; j < cache.medoids.size(); j++)
+			{
+				if (j != position)
+					cache.nearest[i] = std::min(cache.nearest[i], medoid_distance(distance, cache.medoids[j], i));
+			}
+		}
+		else
+		{
+			cache.nearest[i] = std::min(cache.nearest[i], buffers.row[i]);
 		}
-
-		fitness += temp_min;
 	}
-
-	return fitness;
 }
 
-void GeneticEvolution::roulette_selection(std::vector<std::vector<int>>& temp, std::vector<std::vector<int>>* population, std::vector<double>& raw)
+void GeneticEvolution::roulette_selection(std::vector<std::vector<int>>& temp, std::vector<std::vector<int>>* population, std::vector<double>& raw, std::default_random_engine& engine)
 {
 	std::vector<double> refined_fitness(raw.size(), 0.0);
 	double sum = 0.0;
@@ -177,7 +506,7 @@ void GeneticEvolution::roulette_selection(std::vector<std::vector<int>>& temp, s
 		total_slot += scaled_fitness;
 	}
 
-	ConsecutiveRandoms<double> probability(0.0, 1.0);
+	ConsecutiveRandoms<double> probability(0.0, 1.0, engine);
 
 	for (auto i = 0; i < temp.size(); i++)
 	{
@@ -196,6 +525,7 @@ void GeneticEvolution::roulette_selection(std::vector<std::vector<int>>& temp, s
 			if ((mid - 1 >= 0 && candidate >= roulette_slot[mid - 1] && candidate < roulette_slot[mid]) || (mid - 1 < 0 && candidate >= 0.0 && candidate < roulette_slot[mid]))
 			{
 				temp[i] = population->at(mid);
+				this->temp_cache[i] = this->cache[mid];
 				hit = true;
 			}
 
@@ -212,9 +542,10 @@ void GeneticEvolution::roulette_selection(std::vector<std::vector<int>>& temp, s
 
 }
 
-void GeneticEvolution::crossover(std::vector<std::vector<int>>& temp)
+void GeneticEvolution::crossover(std::vector<std::vector<int>>& temp, int generation)
 {
-	ConsecutiveRandoms<int> new_position(0, temp.size() - 1);
+	auto engine = this->stream(generation, pairing_step, 0);
+	ConsecutiveRandoms<int> new_position(0, temp.size() - 1, engine);
 	std::vector<int> swapped_position;
 	swapped_position.reserve(temp.size());
 
@@ -233,7 +564,7 @@ void GeneticEvolution::crossover(std::vector<std::vector<int>>& temp)
 		swapped_position[swap] = actual;
 	}
 
-	ConsecutiveRandoms<double> do_mutation(0.0, 1.0);
+	ConsecutiveRandoms<double> do_mutation(0.0, 1.0, engine);
 
 	//in case of populations made of odd number of solutions, the last one is simply passed in the next generation because has no partner for recombination
 	int even_round = temp.size();
@@ -241,15 +572,24 @@ void GeneticEvolution::crossover(std::vector<std::vector<int>>& temp)
 	if (even_round % 2 == 1)
 		even_round--;
 
+	//pairs that recombine are chosen in order, then the recombinations run in parallel with a stream for each pair
+	std::vector<int> pairs;
 	for (auto i = 0; i < even_round; i += 2)
 	{
 		if (do_mutation.generate() <= this->crossover_prob)
-			recombine(temp[swapped_position[i]], temp[swapped_position[i + 1]]);
+			pairs.push_back(i);
 	}
 
+	this->pool->run(int(pairs.size()), [this, &temp, &swapped_position, &pairs, generation](int task, int worker)
+	{
+		auto i = pairs[task];
+		auto engine = this->stream(generation, crossover_step, i);
+		recombine(temp[swapped_position[i]], temp[swapped_position[i + 1]], engine);
+	});
+
 }
 
-void GeneticEvolution::recombine(std::vector<int>& parent1, std::vector<int>& parent2)
+void GeneticEvolution::recombine(std::vector<int>& parent1, std::vector<int>& parent2, std::default_random_engine& engine)
 {
 	//initialize two sets containing the parents
 	std::set<int> p1(parent1.begin(), parent1.end());
@@ -261,7 +601,7 @@ void GeneticEvolution::recombine(std::vector<int>& parent1, std::vector<int>& pa
 	child.insert(child.end(), parent1.begin(), parent1.end());
 	child.insert(child.end(), parent2.begin(), parent2.end());
 
-	ConsecutiveRandoms<int> new_pos(0, child.size() - 1);
+	ConsecutiveRandoms<int> new_pos(0, child.size() - 1, engine);
 
 	auto scramble = [&child, &new_pos]()
 	{
@@ -276,8 +616,8 @@ void GeneticEvolution::recombine(std::vector<int>& parent1, std::vector<int>& pa
 
 	scramble();
 
-	ConsecutiveRandoms<int> rand_candidate(1, this->nodes->get_size() - 1);
-	ConsecutiveRandoms<double> rand_mutation(0.0, 1.0);
+	ConsecutiveRandoms<int> rand_candidate(1, this->nodes->get_size() - 1, engine);
+	ConsecutiveRandoms<double> rand_mutation(0.0, 1.0, engine);
 
 	/*mutate first i customer in child vector. A mutation is valid if in the vector the same customer appears no more than twice.
 	* p1 and p2 contain the parents so are valid solutions, if a customer can not be inserted in neither of the sets it means the
@@ -349,19 +689,19 @@ void GeneticEvolution::recombine(std::vector<int>& parent1, std::vector<int>& pa
 
 }
 
-void GeneticEvolution::mutation(std::vector<std::vector<int>>& temp)
+void GeneticEvolution::mutation(std::vector<std::vector<int>>& temp, int generation)
 {
 	//mutate a singol customer in the solution. A set is used to check if the mutaion is valid
-	auto mute = [this](std::vector<int>& chromosome)
+	auto mute = [this](std::vector<int>& chromosome, std::default_random_engine& engine)
 	{
 		std::set<int> chrm_set(chromosome.begin(), chromosome.end());
 
-		int position = ConsecutiveRandoms<int>::generate(0, chromosome.size() - 1);
+		int position = ConsecutiveRandoms<int>::generate(0, chromosome.size() - 1, engine);
 		bool mutated = false;
 
 		while (!mutated)
 		{
-			int candidate = ConsecutiveRandoms<int>::generate(1, this->nodes->get_size() - 1);
+			int candidate = ConsecutiveRandoms<int>::generate(1, this->nodes->get_size() - 1, engine);
 
 			if (chrm_set.find(candidate) == chrm_set.end())
 			{
@@ -371,13 +711,14 @@ void GeneticEvolution::mutation(std::vector<std::vector<int>>& temp)
 		}
 	};
 
-	ConsecutiveRandoms<double> do_mutation(0.0, 1.0);
-
-	for (auto i = 0; i < temp.size(); i++)
+	//each chromosome has its own stream
+	this->pool->run(int(temp.size()), [this, &temp, &mute, generation](int i, int worker)
 	{
-		if (do_mutation.generate() <= this->candidate_mutation)
+		auto engine = this->stream(generation, mutation_step, i);
+
+		if (ConsecutiveRandoms<double>::generate(0.0, 1.0, engine) <= this->candidate_mutation)
 		{
-			mute(temp[i]);
+			mute(temp[i], engine);
 		}
-	}
+	});
 }
\ No newline at end of file
@@ -1,5 +1,67 @@
 #pragma once
 #include "NodesDistance.h"
+#include "ThreadPool.h"
+#include "FitnessCache.h"
+#include <cstdint>
+#include <memory>
+#include <random>
+
+/**
+* distance of each customer from the nearest medoid of a chromosome.
+* When a chromosome differs from its cache by a few medoids (mutations, crossovers of similar parents, see
+* GeneticEvolution::fitness_value) each changed medoid is swapped in O(n) as in the swaps of PAM, instead of
+* scanning all the customers against all the medoids. The customers of a removed medoid are the ones whose
+* nearest distance equals their distance from it, so no position of the nearest medoid is kept
+*
+* medoids: medoids the cache refers to, not necessarily in the order of the chromosome
+* nearest: distance of each customer from its nearest medoid
+* fitness: sum of nearest, the fitness value of the chromosome
+*
+*/
+struct medoid_cache
+{
+	std::vector<int> medoids;
+	std::vector<double> nearest;
+	double fitness = 0.0;
+};
+
+/**
+* scratch vectors of fitness_value, one for each worker of the evaluation
+*
+* marked: medoids of a chromosome marked while compared with its cache
+* removed, added: positions of the cache whose medoid is not in the chromosome, and the chromosome's medoids that replace them
+* row, old_row: rows of distances of a medoid, and of the medoid replaced by a swap
+* rows: rows of all the medoids gathered by a new cache (see nearest_medoids)
+* key: canonical key of the evaluated chromosome (see FitnessCache)
+*
+*/
+struct fitness_buffers
+{
+	std::vector<char> marked;
+	std::vector<int> removed;
+	std::vector<int> added;
+	std::vector<double> row;
+	std::vector<double> old_row;
+	std::vector<double> rows;
+	fitness_key key;
+};
+
+/**
+* genetic parameters of an island of GeneticEvolution::island_part, by default the ones of GeneticEvolution
+*
+* population_size: size of the population of the island
+* crossover_prob, crossover_mutation, candidate_mutation: same as in the constructor of GeneticEvolution
+*
+*/
+struct island_settings
+{
+	int population_size = 100;
+	double crossover_prob = 0.65;
+	double crossover_mutation = 0.2;
+	double candidate_mutation = 0.05;
+};
+
+class MigrationRing;
 
 /*
 * class that implements a genetic algorithm based on 
@@ -40,18 +102,137 @@ public:
 	std::vector<std::vector<int>> genetic_part(int groups);
 	std::vector<std::vector<int>> genetic_part(int groups, int n_generations);
 
+	/**
+	* island model: independent populations evolve on separate threads, each with its own settings.
+	* Every few generations each island sends its best chromosomes to the next one (the last one to the first)
+	* through a lock-free ring, they replace the worst chromosomes of the receiver (see set_migration).
+	* Migrations are synchronous: islands wait for each other after sending, every island receives the chromosomes sent
+	* in the same generation, so results with a fixed seed do not depend on the timing of the threads
+	*
+	* input:
+	* groups: total number of clusters in the partition
+	* islands: number of islands, all with the population size and probabilities of this object
+	*  or
+	* settings: settings of each island
+	* n_generations: number of generations evolved by each island
+	*
+	* output:
+	* partition of the best chromosome found by any island
+	*
+	*/
+	std::vector<std::vector<int>> island_part(int groups, int islands);
+	std::vector<std::vector<int>> island_part(int groups, const std::vector<island_settings>& settings, int n_generations);
+
+	/**
+	* migrations of island_part
+	*
+	* input:
+	* interval: generations between two migrations, default 10
+	* migrants: chromosomes sent by each island at every migration, default 2
+	*
+	*/
+	void set_migration(int interval, int migrants);
+
+	/**
+	* seed of the random numbers of the next runs, by default the time of construction.
+	* Every task (a chromosome of the initial population, a crossover, a mutation) has its own stream derived from
+	* the seed, so with the same seed the partition is the same whatever the number of threads
+	*
+	* input:
+	* seed: any value
+	*
+	*/
+	void set_seed(std::uint64_t seed);
+
+	/**
+	* threads that evaluate the population and run crossovers and mutations
+	*
+	* input:
+	* workers: number of threads, 0 means all the available ones (default)
+	*  or
+	* pool: pool shared with other objects, it must not run other tasks during genetic_part
+	*
+	*/
+	void set_workers(int workers);
+	void set_thread_pool(std::shared_ptr<ThreadPool> pool);
+
+	/**
+	* fitness values of the sets of medoids already evaluated, none by default: without a cache every changed chromosome
+	* is evaluated and no key is computed. The islands of island_part share the cache of this object.
+	* It can be shared only by objects with the same distance, get_fitness_cache gives also its hit rate
+	*
+	* input:
+	* memo: cache shared with other objects, nullptr to evaluate without cache
+	*
+	*/
+	void set_fitness_cache(std::shared_ptr<FitnessCache> memo);
+	std::shared_ptr<FitnessCache> get_fitness_cache();
+
 private:
-	double fitness_value(std::vector<int> medoids);
-	void roulette_selection(std::vector<std::vector<int>>& temp, std::vector<std::vector<int>>* population, std::vector<double>& raw);
-	void crossover(std::vector<std::vector<int>>& temp);
-	void recombine(std::vector<int>& parent1, std::vector<int>& parent2);
-	void mutation(std::vector<std::vector<int>>& temp);
+	//steps of genetic_part and island_part
+	void init_population(int groups);
+	void evolve(int generation);
+	void update_best();
+	void send_migrants(MigrationRing& ring, int migrants);
+	void receive_migrants(MigrationRing& ring, int migrants);
+
+	//groups of the partition, each customer is assigned to the nearest medoid
+	std::vector<std::vector<int>> assign(const std::vector<int>& medoids);
+
+	//random stream of a task, see set_seed
+	std::default_random_engine stream(int generation, int step, int index);
+
+	//fitness values of all the chromosomes, in parallel
+	void evaluate(std::vector<std::vector<int>>& population, std::vector<double>& raw);
+
+	//fitness value of a chromosome, cache is updated to its medoids
+	double fitness_value(const std::vector<int>& medoids, medoid_cache& cache, fitness_buffers& buffers);
+
+	//fitness_value with the distance known at compile time (see DistancePolicy.h)
+	template<class Distance>
+	double fitness_value(Distance& distance, const std::vector<int>& medoids, medoid_cache& cache, fitness_buffers& buffers);
+
+	//cache computed from scratch, all customers against all medoids
+	template<class Distance>
+	void init_cache(Distance& distance, const std::vector<int>& medoids, medoid_cache& cache, fitness_buffers& buffers);
+
+	//replaces the medoid in position of the cache with medoid
+	template<class Distance>
+	void swap_medoid(Distance& distance, medoid_cache& cache, int position, int medoid, fitness_buffers& buffers);
+
+	//the caches of the selected chromosomes are copied in temp_cache
+	void roulette_selection(std::vector<std::vector<int>>& temp, std::vector<std::vector<int>>* population, std::vector<double>& raw, std::default_random_engine& engine);
+	void crossover(std::vector<std::vector<int>>& temp, int generation);
+	void recombine(std::vector<int>& parent1, std::vector<int>& parent2, std::default_random_engine& engine);
+	void mutation(std::vector<std::vector<int>>& temp, int generation);
 	NodesDistance* nodes;
 
+	//current population with its fitness values, next one during selection, best chromosome found
+	std::vector<std::vector<int>> population;
+	std::vector<std::vector<int>> temp_population;
+	std::vector<double> raw_fitness;
+	std::vector<int> best_solution;
+	double best_fitness = 0;
+
+	//cache of each chromosome of the population, and of the next one during selection
+	std::vector<medoid_cache> cache;
+	std::vector<medoid_cache> temp_cache;
+
+	//scratch vectors of each worker
+	std::vector<fitness_buffers> buffers;
+
+	std::uint64_t seed;
+	int workers = 0;
+	std::shared_ptr<ThreadPool> pool;
+	std::shared_ptr<FitnessCache> memo;
+
 	//default genetic parameters
 	int number_of_generations = 300;
 	int population_size = 100;
 	double crossover_prob = 0.65;
 	double crossover_mutation = 0.2;
 	double candidate_mutation = 0.05;
+
+	int migration_interval = 10;
+	int migrants = 2;
 };
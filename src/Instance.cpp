@@ -0,0 +1,75 @@
+#include "Instance.h"
+#include "DistanceKernels.h"
+
+Instance::Instance(std::string file, matrix_layout layout)
+{
+	init_nodes(this->node, file);
+	this->init(layout);
+}
+
+Instance::Instance(const nodes& node, matrix_layout layout) : node(node)
+{
+	this->init(layout);
+}
+
+void Instance::init(matrix_layout layout)
+{
+	int size = this->node.id.size();
+	this->spatial_matrix.resize(size, layout);
+	this->time_matrix.resize(size);
+
+	//coordinates as structure of arrays, used by the batch kernels
+	std::vector<double> x(size), y(size);
+	for (auto i = 0; i < size; i++)
+	{
+		x[i] = this->node.coord[i][0];
+		y[i] = this->node.coord[i][1];
+	}
+
+	/*
+	* the kernel gives distance and rounded travel time of the upper part of a row together.
+	* Both are symmetric, the lower part is copied from the rows already computed
+	*/
+	for (auto i = 0; i < size; i++)
+	{
+		auto time_row = this->time_matrix.row(i);
+		euclidean_row(x.data(), y.data(), i, i, size, this->spatial_matrix.upper_row(i), time_row + i);
+
+		for (auto j = 0; j < i; j++)
+		{
+			time_row[j] = this->time_matrix.get(j, i);
+		}
+	}
+
+	if (layout == matrix_layout::full)
+	{
+		for (auto i = 0; i < size; i++)
+		{
+			auto row = this->spatial_matrix.row(i);
+			for (auto j = 0; j < i; j++)
+			{
+				row[j] = this->spatial_matrix.get(j, i);
+			}
+		}
+	}
+}
+
+const nodes& Instance::get_nodes() const
+{
+	return this->node;
+}
+
+int Instance::get_size() const
+{
+	return this->node.id.size();
+}
+
+const DistanceMatrix<double>& Instance::get_spatial_matrix() const
+{
+	return this->spatial_matrix;
+}
+
+const DistanceMatrix<int>& Instance::get_time_matrix() const
+{
+	return this->time_matrix;
+}
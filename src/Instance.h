@@ -0,0 +1,60 @@
+#pragma once
+#include "NodesDistance.h"
+#include "DistanceMatrix.h"
+#include <string>
+#include <vector>
+
+/**
+* immutable VRPTW instance together with the matrices computed from its coordinates
+*
+* Euclidean distances (double) and travel times used by OrTools (rounded int) are computed
+* in a single pass during construction and never change afterwards. An Instance is meant to be
+* created once, held by a std::shared_ptr<const Instance> and borrowed by Spatial, SpatioTemporal,
+* Spatial3d, OrTools and Voronoi, so that nodes and matrices are neither copied nor computed again.
+* Objects built from an instance keep it alive, it can be used safely by many threads.
+*
+*/
+class Instance
+{
+public:
+	/**
+	* constructor from file
+	*
+	* input
+	* file: file name as "name.extension"
+	* layout: storage of the spatial matrix, packed needs half of the memory
+	*
+	*/
+	Instance(std::string file, matrix_layout layout = matrix_layout::full);
+
+	/**
+	* constructor from struct nodes, the nodes are copied once
+	*
+	* input
+	* node: reference to an initialized struct nodes
+	* layout: storage of the spatial matrix, packed needs half of the memory
+	*
+	*/
+	Instance(const nodes& node, matrix_layout layout = matrix_layout::full);
+
+	Instance(const Instance&) = delete;
+	Instance& operator=(const Instance&) = delete;
+
+	const nodes& get_nodes() const;
+
+	//number of customers + depot
+	int get_size() const;
+
+	//Euclidean distance between every pair of customers
+	const DistanceMatrix<double>& get_spatial_matrix() const;
+
+	//travel time between every pair of customers, Euclidean distance rounded to the nearer integer
+	const DistanceMatrix<int>& get_time_matrix() const;
+
+private:
+	nodes node;
+	DistanceMatrix<double> spatial_matrix;
+	DistanceMatrix<int> time_matrix;
+
+	void init(matrix_layout layout);
+};
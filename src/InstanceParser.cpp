@@ -0,0 +1,181 @@
+#include "InstanceParser.h"
+#include "MappedFile.h"
+#include <charconv>
+#include <cstring>
+
+//number of values in a customer row: id, x, y, demand, ready time, due date, service time
+static const int row_values = 7;
+
+//a line of the file without its terminator
+struct line_view
+{
+	const char* begin = nullptr;
+	const char* end = nullptr;
+	int number = 0;
+};
+
+static bool is_blank(char c)
+{
+	return c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v';
+}
+
+static const char* skip_blanks(const char* it, const char* end)
+{
+	while (it != end && is_blank(*it))
+		it++;
+	return it;
+}
+
+static bool blank_line(const line_view& line)
+{
+	return skip_blanks(line.begin, line.end) == line.end;
+}
+
+//true if the first word of the line is word
+static bool first_word_is(const line_view& line, const char* word)
+{
+	auto it = skip_blanks(line.begin, line.end);
+	auto length = std::strlen(word);
+	if (std::size_t(line.end - it) < length || std::memcmp(it, word, length) != 0)
+		return false;
+	return it + length == line.end || is_blank(it[length]);
+}
+
+//reads the next line starting from cursor, returns false at the end of the buffer
+static bool next_line(const char*& cursor, const char* end, line_view& line)
+{
+	if (cursor == end)
+		return false;
+
+	auto terminator = static_cast<const char*>(std::memchr(cursor, '\n', end - cursor));
+	line.begin = cursor;
+	line.end = (terminator == nullptr) ? end : terminator;
+	line.number++;
+	cursor = (terminator == nullptr) ? end : terminator + 1;
+	return true;
+}
+
+//reads the next non blank line, returns false at the end of the buffer
+static bool next_filled_line(const char*& cursor, const char* end, line_view& line)
+{
+	while (next_line(cursor, end, line))
+	{
+		if (!blank_line(line))
+			return true;
+	}
+	return false;
+}
+
+//reads integers from the line until values is full. Returns the number of read values
+static int read_values(const line_view& line, int* values, int n_values, const char*& stop)
+{
+	auto it = line.begin;
+	int read = 0;
+
+	while (read < n_values)
+	{
+		it = skip_blanks(it, line.end);
+		auto result = std::from_chars(it, line.end, values[read]);
+		if (result.ec != std::errc() || (result.ptr != line.end && !is_blank(*result.ptr)))
+			break;
+		it = result.ptr;
+		read++;
+	}
+
+	stop = skip_blanks(it, line.end);
+	return read;
+}
+
+bool parse_nodes(nodes& node, const std::string& file, parse_error& error)
+{
+	node = nodes();
+
+	auto fail = [&node, &error](int line, std::string message)
+	{
+		node = nodes();
+		error.line = line;
+		error.message = std::move(message);
+		return false;
+	};
+
+	MappedFile input(file);
+	if (!input.is_open())
+		return fail(0, "can not open file or file is empty");
+
+	const char* cursor = input.data();
+	const char* end = cursor + input.size();
+	line_view line;
+
+	//vehicle section: "VEHICLE", column names, number of vehicles and capacity
+	bool found = false;
+	while (!found && next_line(cursor, end, line))
+		found = first_word_is(line, "VEHICLE");
+	if (!found)
+		return fail(0, "missing VEHICLE section");
+
+	if (!next_filled_line(cursor, end, line) || !first_word_is(line, "NUMBER"))
+		return fail(line.number, "expected NUMBER and CAPACITY column names");
+
+	if (!next_filled_line(cursor, end, line))
+		return fail(line.number, "missing number of vehicles and capacity");
+
+	int fleet[2];
+	const char* stop;
+	if (read_values(line, fleet, 2, stop) != 2 || stop != line.end)
+		return fail(line.number, "expected number of vehicles and capacity as two integers");
+
+	//customer section: "CUSTOMER", column names, one row per customer. Depot is the first row
+	found = false;
+	while (!found && next_line(cursor, end, line))
+		found = first_word_is(line, "CUSTOMER");
+	if (!found)
+		return fail(0, "missing CUSTOMER section");
+
+	if (!next_filled_line(cursor, end, line) || !first_word_is(line, "CUST"))
+		return fail(line.number, "expected customer column names");
+
+	//first pass: count rows so that every vector is allocated once
+	const char* rows_begin = cursor;
+	int rows_first_line = line.number;
+	int size = 0;
+	while (next_filled_line(cursor, end, line))
+		size++;
+
+	if (size == 0)
+		return fail(line.number, "no customers found");
+
+	node.vehicles = fleet[0];
+	node.capacity = fleet[1];
+	node.id.resize(size);
+	node.coord.resize(size);
+	node.time_window.resize(size);
+	node.demand.resize(size);
+	node.service_time.resize(size);
+
+	//second pass: convert values
+	cursor = rows_begin;
+	line.number = rows_first_line;
+	for (int read = 0; read < size; read++)
+	{
+		next_filled_line(cursor, end, line);
+
+		int values[row_values];
+		auto count = read_values(line, values, row_values, stop);
+		if (count != row_values && stop != line.end)
+			return fail(line.number, "value " + std::to_string(count + 1) + " is not an integer");
+		if (count != row_values)
+			return fail(line.number, "expected " + std::to_string(row_values) + " values, read " + std::to_string(count));
+		if (stop != line.end)
+			return fail(line.number, "unexpected value after service time");
+
+		node.id[read] = values[0];
+		node.coord[read][0] = values[1];
+		node.coord[read][1] = values[2];
+		node.demand[read] = values[3];
+		node.time_window[read][0] = values[4];
+		node.time_window[read][1] = values[5];
+		node.service_time[read] = values[6];
+	}
+
+	return true;
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include "NodesDistance.h"
+#include <string>
+
+/**
+* describes why an instance file could not be parsed
+*
+* line: 1-based line of the file where the problem was found, 0 if the problem is not related to a line
+* message: description of the problem
+*
+*/
+struct parse_error
+{
+	int line = 0;
+	std::string message;
+};
+
+/**
+* initializes a struct nodes based on the data of a file with the layout of
+* Solomon's and Gehring-Homberger's instances.
+*
+* The file is memory-mapped and read in two passes: the first one counts the
+* customer rows, so each vector in the structure is allocated once, the second
+* one converts the values with std::from_chars
+*
+* input:
+* node: reference to the to be initialized structure
+* file: file name as "name.extension"
+* error: reference to the structure describing the first problem found
+*
+* output:
+* true if the whole file has been read, otherwise node is left empty and error is set
+*
+*/
+bool parse_nodes(nodes& node, const std::string& file, parse_error& error);
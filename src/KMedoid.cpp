@@ -1,5 +1,6 @@
 #include "KMedoid.h"
 #include "ConsecutiveRandoms.h"
+#include "DistancePolicy.h"
 #include <set>
 #include <iostream>
 
@@ -14,14 +15,27 @@ std::vector<std::vector<int>> KMedoid::medoid_part(int groups)
 }
 
 std::vector<std::vector<int>> KMedoid::medoid_part(int groups, int n_iter)
+{
+	return visit_distance(*this->nodes, [this, groups, n_iter](auto& distance)
+	{
+		return this->medoid_part(distance, groups, n_iter);
+	});
+}
+
+template<class Distance>
+std::vector<std::vector<int>> KMedoid::medoid_part(Distance& distance, int groups, int n_iter)
 {
 	std::vector<int> solution_medoid;
+	std::vector<int> medoid_position;
+	std::vector<double> rows;
+	std::vector<double> nearest(distance.get_size());
+	std::vector<int> label(distance.get_size());
 	double partition_cost = 0;
 
 	//make n_iter attempts and take best group of medoids
 	for (int attempt = 0; attempt < n_iter; attempt++)
 	{
-		ConsecutiveRandoms<int> rand_medoid(1, this->nodes->get_size() - 1);
+		ConsecutiveRandoms<int> rand_medoid(1, distance.get_size() - 1);
 		std::set<int> temp_medoid;
 		std::vector<int> medoid(groups);
 
@@ -47,29 +61,19 @@ std::vector<std::vector<int>> KMedoid::medoid_part(int groups, int n_iter)
 			std::vector<double> medoid_cost(groups, 0);
 
 			//reserve space for each group, insert medoids
-			int medium_size = (this->nodes->get_size() - 1) / groups;
+			int medium_size = (distance.get_size() - 1) / groups;
 			for (auto i = 0; i < medoid.size(); i++)
 			{
 				actual_partition[i].reserve(medium_size);
 			}
 
-			//assign customers to the nearer group
-			for (auto i = 1; i < this->nodes->get_size(); i++)
+			//assign customers to the nearer group, with the neighbour lists when they are built
+			medoid_positions(medoid, distance.get_size(), medoid_position);
+			nearest_medoids(distance, medoid, medoid_position, rows, nearest.data(), label.data());
+			for (auto i = 1; i < distance.get_size(); i++)
 			{
-				double min_distance = this->nodes->get_distance(medoid[0], i);
-				int best_medoid = 0;
-				for (int j = 1; j < medoid.size(); j++)
-				{
-					auto temp_distance = this->nodes->get_distance(medoid[j], i);
-					if (temp_distance < min_distance)
-					{
-						min_distance = temp_distance;
-						best_medoid = j;
-					}
-				}
-
-				actual_partition[best_medoid].push_back(i);
-				medoid_cost[best_medoid] += min_distance;
+				actual_partition[label[i]].push_back(i);
+				medoid_cost[label[i]] += nearest[i];
 			}
 
 			//look for better medoids
@@ -78,12 +82,7 @@ std::vector<std::vector<int>> KMedoid::medoid_part(int groups, int n_iter)
 				for (auto j = 1; j < actual_partition[i].size(); j++)
 				{
 					auto candidate = actual_partition[i][j];
-					double candidate_group_distance = 0;
-
-					for (auto k = 0; k < actual_partition[i].size(); k++)
-					{
-						candidate_group_distance += this->nodes->get_distance(candidate, actual_partition[i][k]);
-					}
+					double candidate_group_distance = group_distance(distance, candidate, actual_partition[i]);
 
 					//update medoid if there is a better gravity point
 					if (candidate_group_distance < medoid_cost[i])
@@ -112,21 +111,11 @@ std::vector<std::vector<int>> KMedoid::medoid_part(int groups, int n_iter)
 
 	//create partition from medoids with lowest cost
 	std::vector<std::vector<int>> solution_partition(groups, std::vector<int>());
-	for (auto i = 1; i < this->nodes->get_size(); i++)
+	medoid_positions(solution_medoid, distance.get_size(), medoid_position);
+	nearest_medoids(distance, solution_medoid, medoid_position, rows, nullptr, label.data());
+	for (auto i = 1; i < distance.get_size(); i++)
 	{
-		double min_distance = this->nodes->get_distance(solution_medoid[0], i);
-		int best_medoid = 0;
-		for (int j = 1; j < solution_medoid.size(); j++)
-		{
-			auto temp_distance = this->nodes->get_distance(solution_medoid[j], i);
-			if (temp_distance < min_distance)
-			{
-				min_distance = temp_distance;
-				best_medoid = j;
-			}
-		}
-
-		solution_partition[best_medoid].push_back(i);
+		solution_partition[label[i]].push_back(i);
 	}
 
 	return solution_partition;
@@ -33,6 +33,10 @@ public:
 	std::vector<std::vector<int>> medoid_part(int groups, int n_iter);
 
 private:
+	//medoid_part with the distance known at compile time (see DistancePolicy.h)
+	template<class Distance>
+	std::vector<std::vector<int>> medoid_part(Distance& distance, int groups, int n_iter);
+
 	NodesDistance* nodes;
 	int iterations = 150;
 
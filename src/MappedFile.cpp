@@ -0,0 +1,142 @@
+#include "MappedFile.h"
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const std::string& file)
+{
+	this->open(file);
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+{
+	*this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+	if (this != &other)
+	{
+		this->close();
+		std::swap(this->begin, other.begin);
+		std::swap(this->length, other.length);
+#ifdef _WIN32
+		std::swap(this->file_handle, other.file_handle);
+		std::swap(this->mapping_handle, other.mapping_handle);
+#endif
+	}
+	return *this;
+}
+
+MappedFile::~MappedFile()
+{
+	this->close();
+}
+
+bool MappedFile::open(const std::string& file)
+{
+	this->close();
+
+#ifdef _WIN32
+	HANDLE handle = CreateFileA(file.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (handle == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER file_size;
+	if (!GetFileSizeEx(handle, &file_size) || file_size.QuadPart == 0)
+	{
+		CloseHandle(handle);
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping == nullptr)
+	{
+		CloseHandle(handle);
+		return false;
+	}
+
+	auto view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (view == nullptr)
+	{
+		CloseHandle(mapping);
+		CloseHandle(handle);
+		return false;
+	}
+
+	this->file_handle = handle;
+	this->mapping_handle = mapping;
+	this->begin = static_cast<const char*>(view);
+	this->length = std::size_t(file_size.QuadPart);
+#else
+	int descriptor = ::open(file.c_str(), O_RDONLY);
+	if (descriptor < 0)
+		return false;
+
+	struct stat info;
+	if (fstat(descriptor, &info) != 0 || info.st_size == 0)
+	{
+		::close(descriptor);
+		return false;
+	}
+
+	auto view = mmap(nullptr, std::size_t(info.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0);
+
+	//the mapping stays valid after the descriptor is closed
+	::close(descriptor);
+	if (view == MAP_FAILED)
+		return false;
+
+	//files are mostly read from front to back
+	madvise(view, std::size_t(info.st_size), MADV_SEQUENTIAL);
+
+	this->begin = static_cast<const char*>(view);
+	this->length = std::size_t(info.st_size);
+#endif
+
+	return true;
+}
+
+void MappedFile::close()
+{
+	if (this->begin == nullptr)
+		return;
+
+#ifdef _WIN32
+	UnmapViewOfFile(this->begin);
+	CloseHandle(this->mapping_handle);
+	CloseHandle(this->file_handle);
+	this->mapping_handle = nullptr;
+	this->file_handle = nullptr;
+#else
+	munmap(const_cast<char*>(this->begin), this->length);
+#endif
+
+	this->begin = nullptr;
+	this->length = 0;
+}
+
+bool MappedFile::is_open() const
+{
+	return this->begin != nullptr;
+}
+
+const char* MappedFile::data() const
+{
+	return this->begin;
+}
+
+std::size_t MappedFile::size() const
+{
+	return this->length;
+}
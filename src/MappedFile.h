@@ -0,0 +1,63 @@
+#pragma once
+#include <string>
+#include <cstddef>
+
+/**
+* read-only memory mapping of a whole file
+*
+* the mapping is released when the object is destroyed. Files that can not be
+* opened or that are empty give a closed mapping (is_open() returns false)
+*
+*/
+class MappedFile
+{
+public:
+	MappedFile() = default;
+
+	/**
+	* constructor from file
+	*
+	* input
+	* file: file name as "name.extension"
+	*
+	*/
+	MappedFile(const std::string& file);
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+	MappedFile(MappedFile&& other) noexcept;
+	MappedFile& operator=(MappedFile&& other) noexcept;
+	~MappedFile();
+
+	/**
+	* maps a file, an already mapped file is released first
+	*
+	* input:
+	* file: file name as "name.extension"
+	*
+	* output:
+	* true if the whole file is mapped
+	*
+	*/
+	bool open(const std::string& file);
+
+	//releases the mapping
+	void close();
+
+	bool is_open() const;
+
+	//first byte of the mapping
+	const char* data() const;
+
+	//size of the mapping in bytes
+	std::size_t size() const;
+
+private:
+	const char* begin = nullptr;
+	std::size_t length = 0;
+
+#ifdef _WIN32
+	void* file_handle = nullptr;
+	void* mapping_handle = nullptr;
+#endif
+};
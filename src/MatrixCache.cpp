@@ -0,0 +1,134 @@
+#include "MatrixCache.h"
+#include "ContentHash.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <system_error>
+#include <tuple>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static const char cache_extension[] = ".vrpsnap";
+
+MatrixCache::MatrixCache(std::string directory, std::uint64_t max_bytes)
+{
+	this->directory = directory;
+	this->max_bytes = max_bytes;
+
+	std::error_code error;
+	fs::create_directories(this->directory, error);
+}
+
+std::string MatrixCache::key(const nodes& node, double k1, double k2, double k3, double alpha1)
+{
+	std::uint64_t hash = content_hash(node.id.data(), node.id.size() * sizeof(int));
+	hash = content_hash(node.coord.data(), node.coord.size() * sizeof(node.coord[0]), hash);
+	hash = content_hash(node.time_window.data(), node.time_window.size() * sizeof(node.time_window[0]), hash);
+	hash = content_hash(node.demand.data(), node.demand.size() * sizeof(int), hash);
+	hash = content_hash(node.service_time.data(), node.service_time.size() * sizeof(int), hash);
+
+	int fleet[2] = { node.vehicles, node.capacity };
+	double parameters[4] = { k1, k2, k3, alpha1 };
+	hash = content_hash(fleet, sizeof(fleet), hash);
+	hash = content_hash(parameters, sizeof(parameters), hash);
+
+	char digits[17];
+	std::snprintf(digits, sizeof(digits), "%016llx", static_cast<unsigned long long>(hash));
+	return digits;
+}
+
+std::string MatrixCache::path(const std::string& key) const
+{
+	return (fs::path(this->directory) / (key + cache_extension)).string();
+}
+
+bool MatrixCache::open(const nodes& node, double k1, double k2, double k3, double alpha1, NodesSnapshot& snapshot)
+{
+	auto file = this->path(key(node, k1, k2, k3, alpha1));
+
+	std::error_code error;
+	if (!fs::exists(file, error))
+		return false;
+
+	std::string reason;
+	if (!snapshot.open(file, reason) || !snapshot.verify(reason))
+	{
+		snapshot = NodesSnapshot();
+		fs::remove(file, error);
+		return false;
+	}
+
+	//the modification time is used as time of the last use
+	fs::last_write_time(file, fs::file_time_type::clock::now(), error);
+	return true;
+}
+
+bool MatrixCache::store(nodes& node, const snapshot_matrices& matrices)
+{
+	auto file = this->path(key(node, matrices.parameters[0], matrices.parameters[1], matrices.parameters[2], matrices.parameters[3]));
+
+	//a unique temporary name, concurrent runs may store the same instance
+	auto temporary = file + ".tmp" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+
+	std::error_code error;
+	if (!write_snapshot(temporary, node, matrices))
+	{
+		fs::remove(temporary, error);
+		return false;
+	}
+
+	fs::rename(temporary, file, error);
+	if (error)
+	{
+		fs::remove(temporary, error);
+		return false;
+	}
+
+	this->evict();
+	return true;
+}
+
+std::uint64_t MatrixCache::size() const
+{
+	std::uint64_t total = 0;
+	std::error_code error;
+
+	for (auto& entry : fs::directory_iterator(this->directory, error))
+	{
+		if (entry.path().extension() == cache_extension)
+			total += entry.file_size(error);
+	}
+	return total;
+}
+
+void MatrixCache::evict()
+{
+	if (this->max_bytes == 0)
+		return;
+
+	//last use, size and path of every cached snapshot
+	std::vector<std::tuple<fs::file_time_type, std::uint64_t, fs::path>> cached;
+	std::uint64_t total = 0;
+	std::error_code error;
+
+	for (auto& entry : fs::directory_iterator(this->directory, error))
+	{
+		if (entry.path().extension() != cache_extension)
+			continue;
+
+		auto bytes = entry.file_size(error);
+		cached.emplace_back(entry.last_write_time(error), bytes, entry.path());
+		total += bytes;
+	}
+
+	std::sort(cached.begin(), cached.end());
+
+	//the most recent snapshot is kept even if it exceeds the limit alone
+	for (std::size_t i = 0; i + 1 < cached.size() && total > this->max_bytes; i++)
+	{
+		if (fs::remove(std::get<2>(cached[i]), error))
+			total -= std::get<1>(cached[i]);
+	}
+}
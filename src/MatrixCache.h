@@ -0,0 +1,79 @@
+#pragma once
+#include "NodesDistance.h"
+#include "NodesSnapshot.h"
+#include <cstdint>
+#include <string>
+
+/**
+* directory of snapshots (see NodesSnapshot) reused by later runs on the same instance
+*
+* A snapshot is stored under a content hash of the nodes and of the spatiotemporal parameters
+* (k1, k2, k3, alpha1), so a run finds the matrices computed by a previous one whatever the name of the
+* instance file. Cached snapshots are memory-mapped and their checksum is verified before use.
+* When the files exceed the size limit the least recently used ones are removed.
+*
+* Snapshots are first written to a temporary file and then renamed, a run never sees a partial file.
+*
+*/
+class MatrixCache
+{
+public:
+	/**
+	* constructor, the directory is created if it does not exist
+	*
+	* input:
+	* directory: folder of the cached snapshots
+	* max_bytes: limit of the total size of the cached snapshots, 0 means no limit
+	*
+	*/
+	MatrixCache(std::string directory, std::uint64_t max_bytes = 0);
+
+	/**
+	* key of an instance and of the parameters of its spatiotemporal matrices
+	*
+	* output:
+	* 16 hexadecimal digits
+	*
+	*/
+	static std::string key(const nodes& node, double k1, double k2, double k3, double alpha1);
+
+	/**
+	* opens the cached snapshot of an instance. A corrupted or unreadable snapshot is removed from the cache
+	*
+	* input:
+	* node: reference to an initialized struct nodes
+	* k1, k2, k3, alpha1: parameters of the spatiotemporal matrices
+	* snapshot: reference to the snapshot to be opened
+	*
+	* output:
+	* true if the snapshot was in the cache and has been opened
+	*
+	*/
+	bool open(const nodes& node, double k1, double k2, double k3, double alpha1, NodesSnapshot& snapshot);
+
+	/**
+	* stores the snapshot of an instance, then removes the least recently used snapshots exceeding the limit.
+	* The key uses the parameters in matrices (see SpatioTemporal::add_to_snapshot)
+	*
+	* input:
+	* node: reference to an initialized struct nodes
+	* matrices: matrices to be stored
+	*
+	* output:
+	* true if the snapshot has been written
+	*
+	*/
+	bool store(nodes& node, const snapshot_matrices& matrices);
+
+	//total size in bytes of the cached snapshots
+	std::uint64_t size() const;
+
+private:
+	std::string directory;
+	std::uint64_t max_bytes = 0;
+
+	std::string path(const std::string& key) const;
+
+	//removes the least recently used snapshots until the total size is within the limit
+	void evict();
+};
@@ -0,0 +1,30 @@
+#include "MigrationRing.h"
+
+MigrationRing::MigrationRing(int capacity, int groups)
+{
+	this->slots.assign(capacity + 1, std::vector<int>(groups));
+}
+
+bool MigrationRing::push(const std::vector<int>& chromosome)
+{
+	auto tail = this->tail.load(std::memory_order_relaxed);
+	auto next = (tail + 1) % int(this->slots.size());
+	if (next == this->head.load(std::memory_order_acquire))
+		return false;
+
+	//the slot is not read by the consumer until tail moves
+	this->slots[tail].assign(chromosome.begin(), chromosome.end());
+	this->tail.store(next, std::memory_order_release);
+	return true;
+}
+
+bool MigrationRing::pop(std::vector<int>& chromosome)
+{
+	auto head = this->head.load(std::memory_order_relaxed);
+	if (head == this->tail.load(std::memory_order_acquire))
+		return false;
+
+	chromosome.assign(this->slots[head].begin(), this->slots[head].end());
+	this->head.store((head + 1) % int(this->slots.size()), std::memory_order_release);
+	return true;
+}
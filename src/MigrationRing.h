@@ -0,0 +1,59 @@
+#pragma once
+#include <atomic>
+#include <vector>
+
+/**
+* lock-free ring of chromosomes from one producer thread to one consumer thread, used by the islands of
+* GeneticEvolution::island_part to send their best chromosomes to the next island.
+* Slots are allocated once, push and pop copy the medoids and never wait: when the ring is full the
+* chromosome is dropped, when it is empty nothing is received
+*
+*/
+class MigrationRing
+{
+public:
+	/**
+	* constructor
+	*
+	* input:
+	* capacity: maximum number of chromosomes in the ring
+	* groups: number of medoids of a chromosome
+	*
+	*/
+	MigrationRing(int capacity, int groups);
+
+	MigrationRing(const MigrationRing&) = delete;
+	MigrationRing& operator=(const MigrationRing&) = delete;
+
+	/**
+	* called only by the producer
+	*
+	* input:
+	* chromosome: medoids copied in the ring
+	*
+	* output:
+	* false if the ring is full
+	*
+	*/
+	bool push(const std::vector<int>& chromosome);
+
+	/**
+	* called only by the consumer
+	*
+	* input:
+	* chromosome: receives the oldest chromosome of the ring
+	*
+	* output:
+	* false if the ring is empty
+	*
+	*/
+	bool pop(std::vector<int>& chromosome);
+
+private:
+	//one slot more than the capacity, head == tail means empty
+	std::vector<std::vector<int>> slots;
+
+	//next slot read by the consumer and next slot written by the producer, on different cache lines
+	alignas(64) std::atomic<int> head{ 0 };
+	alignas(64) std::atomic<int> tail{ 0 };
+};
@@ -1,64 +1,36 @@
 #include "NodesDistance.h"
-#include <fstream>
+#include "InstanceParser.h"
+#include "NodesSnapshot.h"
+#include "Instance.h"
+#include "DistancePolicy.h"
+#include "ParallelFor.h"
+#include <algorithm>
+#include <iostream>
+#include <utility>
 
 void init_nodes(nodes &node, std::string file)
 {
-	int size = 0;
+	parse_error error;
 
-	//resize all vectors in the structure according to the new_size parameter; 
-	auto resize = [&size, &node](int new_size)
+	//malformed files leave node empty, the reason is reported with the line where the problem was found
+	if (!parse_nodes(node, file, error))
 	{
-		size = new_size;
-		node.id.resize(size);
-		node.coord.resize(size);
-		node.time_window.resize(size);
-		node.demand.resize(size);
-		node.service_time.resize(size);
-	};
-
-	std::ifstream input(file);
-	if (input.is_open())
-	{
-		resize(100);
-		//number of lines read
-		int read = 0;
-		std::string line;
-		std::string word;
-
-		while (std::getline(input, line) && read < 7)
-		{
-			if (read == 3)
-			{
-				input >> node.vehicles;
-				input >> node.capacity;
-			}
-			read++;
-		}
-
-		//number of lines read which is equal to the number of read customers
-		read = 0;
-		while (input >> word && (word.compare("") != 0))
-		{
-			node.id[read] = std::stoi(word);
-			input >> node.coord[read][0];
-			input >> node.coord[read][1];
-			input >> node.demand[read];
-			input >> node.time_window[read][0];
-			input >> node.time_window[read][1];
-			input >> node.service_time[read];
-
-			read++;
-			if (read >= size)
-				resize(size * 2);
-		}
-		if (size != read)
-			resize(read);
-
-		input.close();
+		std::cerr << file << ":" << error.line << ": " << error.message << std::endl;
 	}
 }
 
-void init_sub_nodes(nodes& node, nodes& sub_nodes, std::vector<int>& sub_id)
+void init_nodes(nodes& node, const nodes_view& view)
+{
+	node.vehicles = view.vehicles;
+	node.capacity = view.capacity;
+	node.id.assign(view.id, view.id + view.size);
+	node.coord.assign(view.coord, view.coord + view.size);
+	node.time_window.assign(view.time_window, view.time_window + view.size);
+	node.demand.assign(view.demand, view.demand + view.size);
+	node.service_time.assign(view.service_time, view.service_time + view.size);
+}
+
+void init_sub_nodes(const nodes& node, nodes& sub_nodes, std::vector<int>& sub_id)
 {
 	//number of ids of the sub-problem (depot is not included)
 	auto size = sub_id.size();
@@ -93,14 +65,32 @@ void init_sub_nodes(nodes& node, nodes& sub_nodes, std::vector<int>& sub_id)
 
 NodesDistance::NodesDistance(std::string file)
 {
-	init_nodes(this->node, file);
-	this->size = node.id.size();
+	auto node = std::make_shared<nodes>();
+	init_nodes(*node, file);
+	this->node = node;
+	this->size = node->id.size();
 }
 
 NodesDistance::NodesDistance(nodes& nodes)
 {
-	this->node = nodes;
-	this->size = node.id.size();
+	this->node = std::make_shared<const struct nodes>(nodes);
+	this->size = this->node->id.size();
+}
+
+NodesDistance::NodesDistance(NodesSnapshot& snapshot)
+{
+	//the distances read the nodes as vectors, the columns are small compared to the matrices
+	auto node = std::make_shared<nodes>();
+	init_nodes(*node, snapshot.view());
+	this->node = node;
+	this->size = node->id.size();
+}
+
+NodesDistance::NodesDistance(std::shared_ptr<const Instance> instance)
+{
+	//shares the ownership of the instance, pointing to its nodes
+	this->node = std::shared_ptr<const nodes>(instance, &instance->get_nodes());
+	this->size = instance->get_size();
 }
 
 int NodesDistance::get_size()
@@ -108,6 +98,78 @@ int NodesDistance::get_size()
 	return this->size;
 }
 
+void NodesDistance::add_to_snapshot(snapshot_matrices& matrices)
+{
+	//every distance is computed by get_distance, there is no matrix to store
+}
+
+std::size_t NodesDistance::get_memory()
+{
+	return 0;
+}
+
+void NodesDistance::build_neighbours(int k, int workers)
+{
+	if (workers <= 0)
+		workers = worker_count();
+
+	//every customer has the same number of neighbours, the depot has one more candidate
+	k = std::max(0, std::min(k, this->size - 2));
+	this->neighbour.offset.resize(this->size + 1);
+	for (auto i = 0; i <= this->size; i++)
+	{
+		this->neighbour.offset[i] = i * k;
+	}
+	this->neighbour.id.resize(this->size * k);
+	this->neighbour.distance.resize(this->size * k);
+
+	//(distance, id) of the candidates and a row of distances for each thread
+	std::vector<std::vector<std::pair<double, int>>> candidates(workers, std::vector<std::pair<double, int>>(this->size));
+	std::vector<std::vector<double>> rows(workers, std::vector<double>(this->size));
+
+	visit_distance(*this, [this, k, workers, &candidates, &rows](auto& distance)
+	{
+		using Distance = std::remove_reference_t<decltype(distance)>;
+
+		parallel_for(this->size, [this, k, &distance, &candidates, &rows](int i, int worker)
+		{
+			auto& candidate = candidates[worker];
+			auto& row = rows[worker];
+
+			if constexpr (has_distance_row<Distance>::value)
+			{
+				distance.distance_row(i, 0, this->size, row.data());
+			}
+			else
+			{
+				for (auto j = 0; j < this->size; j++)
+				{
+					row[j] = distance.distance(i, j);
+				}
+			}
 
+			int count = 0;
+			for (auto j = 1; j < this->size; j++)
+			{
+				if (j != i)
+					candidate[count++] = { row[j], j };
+			}
 
+			//only the k nearest are sorted
+			std::nth_element(candidate.begin(), candidate.begin() + k, candidate.begin() + count);
+			std::sort(candidate.begin(), candidate.begin() + k);
 
+			auto first = this->neighbour.offset[i];
+			for (auto j = 0; j < k; j++)
+			{
+				this->neighbour.distance[first + j] = candidate[j].first;
+				this->neighbour.id[first + j] = candidate[j].second;
+			}
+		}, workers);
+	});
+}
+
+std::size_t NodesDistance::get_neighbour_memory() const
+{
+	return this->neighbour.offset.size() * sizeof(int) + this->neighbour.id.size() * sizeof(int) + this->neighbour.distance.size() * sizeof(double);
+}
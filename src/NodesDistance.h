@@ -2,6 +2,7 @@
 #include <vector>
 #include <string>
 #include <array>
+#include <memory>
 
 /**
 * contains all the informations about a VRPTW instance
@@ -20,10 +21,48 @@ struct nodes
 	int capacity = 0;
 };
 
+/**
+* read-only view over the columns of a VRPTW instance stored somewhere else (e.g. a mapped NodesSnapshot)
+*
+* each column has size elements, no copy of the data is made
+*
+*/
+struct nodes_view
+{
+	const int* id = nullptr;
+	const std::array<int, 2>* coord = nullptr;
+	const std::array<int, 2>* time_window = nullptr;
+	const int* demand = nullptr;
+	const int* service_time = nullptr;
+	int size = 0;
+	int vehicles = 0;
+	int capacity = 0;
+};
+
+class NodesSnapshot;
+class Instance;
+struct snapshot_matrices;
+
+/**
+* k-nearest-neighbour lists of all customers in compressed sparse row format
+*
+* neighbours of customer i are id[offset[i]] ... id[offset[i + 1] - 1], sorted by increasing distance
+* (lower id first in case of ties), distance[k] is the distance between customer i and id[k]
+*
+*/
+struct neighbour_lists
+{
+	std::vector<int> offset;
+	std::vector<int> id;
+	std::vector<double> distance;
+};
+
 
 /**
 * initializes a struct nodes based on the data of a file. The file is
 * expected to have the same layout of Solomon's instances. 
+* If the file can not be read node is left empty and the reason, with the
+* line where it was found, is written on std::cerr (see parse_nodes)
 * 
 * input:
 * node: reference to the to be initialized structure
@@ -32,9 +71,20 @@ struct nodes
 */
 void init_nodes(nodes &node, std::string file);
 
+/**
+* initializes a struct nodes copying the columns of a view
+*
+* input:
+* node: reference to the to be initialized structure
+* view: view over the columns of an instance
+*
+*/
+void init_nodes(nodes &node, const nodes_view &view);
+
 
 /**
-* initializes a struct node for a sub problem based on an already initialized struct node
+* initializes a struct node for a sub problem based on an already initialized struct node.
+* The data are copied, SubInstance gives the same sub problem without copies
 * 
 * input
 * node: reference to the already initialized structure
@@ -42,7 +92,7 @@ void init_nodes(nodes &node, std::string file);
 * sub_id: contains the customers' ids of the desired sub problem
 * 
 */
-void init_sub_nodes(nodes &node, nodes &sub_nodes, std::vector<int>& sub_id);
+void init_sub_nodes(const nodes &node, nodes &sub_nodes, std::vector<int>& sub_id);
 
 
 /**
@@ -74,6 +124,25 @@ public:
 	*/
 	NodesDistance(nodes& nodes);
 
+	/**
+	* constructor from snapshot. The columns of the nodes are copied from the mapped view, the classes
+	* derived from NodesDistance borrow only the stored matrices
+	*
+	* input
+	* snapshot: reference to an opened NodesSnapshot
+	*
+	*/
+	NodesDistance(NodesSnapshot& snapshot);
+
+	/**
+	* constructor from a shared instance, its nodes are borrowed without copies
+	*
+	* input
+	* instance: instance shared with other objects, kept alive by this object
+	*
+	*/
+	NodesDistance(std::shared_ptr<const Instance> instance);
+
 	/*
 	* virtual function for the to be implemented distance
 	* 
@@ -87,6 +156,16 @@ public:
 	*/
 	virtual double get_distance(int from_id, int to_id) = 0;
 
+	/**
+	* non virtual distance used by the distance policies (see DistancePolicy.h).
+	* Derived classes hide it with an inline version, the base one calls get_distance
+	*
+	*/
+	double distance(int from_id, int to_id)
+	{
+		return this->get_distance(from_id, to_id);
+	}
+
 	/**
 	* size of the problem
 	* 
@@ -95,8 +174,65 @@ public:
 	*/
 	int get_size();
 
+	/**
+	* adds the matrices computed by the class to the ones written in a snapshot (see write_snapshot).
+	* The base class has no matrices
+	*
+	* input:
+	* matrices: reference to the structure passed to write_snapshot, must not outlive this object
+	*
+	*/
+	virtual void add_to_snapshot(snapshot_matrices& matrices);
+
+	//memory used by the matrices of the class in bytes, the base class has no matrices
+	virtual std::size_t get_memory();
+
+	/**
+	* builds the sorted lists of the k nearest customers of every customer, with any distance.
+	* Rows are computed in parallel and only their k smallest values are sorted, customers can then be
+	* compared with k candidates instead of the whole row. The depot and the customer itself are never neighbours.
+	* The distance is assumed symmetric, as all the derived classes
+	*
+	* input:
+	* k: maximum number of neighbours per customer
+	* workers: number of threads, 0 means all the available ones
+	*
+	*/
+	void build_neighbours(int k, int workers = 0);
+
+	//true after build_neighbours
+	bool has_neighbours() const
+	{
+		return !this->neighbour.offset.empty();
+	}
+
+	//number of neighbours of a customer
+	int neighbour_count(int customer) const
+	{
+		return this->neighbour.offset[customer + 1] - this->neighbour.offset[customer];
+	}
+
+	//ids of the neighbours of a customer, nearest first
+	const int* neighbours(int customer) const
+	{
+		return this->neighbour.id.data() + this->neighbour.offset[customer];
+	}
+
+	//distances of the neighbours of a customer, in the same order of neighbours
+	const double* neighbour_distances(int customer) const
+	{
+		return this->neighbour.distance.data() + this->neighbour.offset[customer];
+	}
+
+	//memory used by the neighbour lists in bytes
+	std::size_t get_neighbour_memory() const;
+
 protected:
-	nodes node;
+	//nodes owned by this object or borrowed from an Instance, never modified after construction
+	std::shared_ptr<const nodes> node;
 	int size = 0;
+
+	//empty until build_neighbours
+	neighbour_lists neighbour;
 };
 
@@ -0,0 +1,343 @@
+#include "NodesSnapshot.h"
+#include "ContentHash.h"
+#include <fstream>
+#include <cstring>
+
+//every block starts on a multiple of block_alignment bytes
+static const std::uint64_t block_alignment = 64;
+static const char snapshot_magic[8] = { 'V', 'R', 'P', 'S', 'N', 'A', 'P', '\0' };
+static const std::uint32_t snapshot_version = 3;
+
+//blocks of the file in order
+enum snapshot_block
+{
+	id_block,
+	coord_block,
+	time_window_block,
+	demand_block,
+	service_time_block,
+	spatial_block,
+	temporal_block,
+	spatio_temporal_block,
+	time_block,
+	number_of_blocks
+};
+
+//offset and size in bytes of a block, a missing block has size 0. Layout is used only by matrices
+struct snapshot_entry
+{
+	std::uint64_t offset;
+	std::uint64_t bytes;
+	std::uint32_t layout;
+	std::uint32_t reserved;
+};
+
+struct snapshot_header
+{
+	char magic[8];
+	std::uint32_t version;
+	std::uint32_t size;
+	std::int32_t vehicles;
+	std::int32_t capacity;
+	double parameters[4];
+
+	//see snapshot_checksum
+	std::uint64_t checksum;
+	snapshot_entry entry[number_of_blocks];
+};
+
+static std::uint64_t align_block(std::uint64_t offset)
+{
+	return (offset + block_alignment - 1) / block_alignment * block_alignment;
+}
+
+/**
+* checksum of the header, taken with checksum set to 0, and of the blocks in order (padding excluded).
+* The time matrix is added a row at a time, rows are separate vectors when the snapshot is written
+*
+* input:
+* header: header of the snapshot, size and entries must be set
+* block: first byte of every block, unused for missing blocks
+* time_row: callable as time_row(int i), first value of row i of the time matrix
+*
+*/
+template<class TimeRow>
+static std::uint64_t snapshot_checksum(snapshot_header header, const void* const* block, TimeRow time_row)
+{
+	header.checksum = 0;
+	auto checksum = content_hash(&header, sizeof(header));
+
+	for (auto i = 0; i < time_block; i++)
+	{
+		if (header.entry[i].bytes > 0)
+			checksum = content_hash(block[i], header.entry[i].bytes, checksum);
+	}
+
+	if (header.entry[time_block].bytes > 0)
+	{
+		for (std::uint32_t i = 0; i < header.size; i++)
+			checksum = content_hash(time_row(i), header.size * sizeof(std::int32_t), checksum);
+	}
+
+	return checksum;
+}
+
+bool write_snapshot(const std::string& file, nodes& node, const snapshot_matrices& matrices)
+{
+	std::uint64_t size = node.id.size();
+	std::uint64_t column = size * sizeof(std::int32_t);
+	std::uint64_t int_matrix = size * size * sizeof(std::int32_t);
+	const DistanceMatrix<double>* stored[3] = { matrices.spatial, matrices.temporal, matrices.spatio_temporal };
+
+	snapshot_header header;
+	std::memset(&header, 0, sizeof(header));
+	std::memcpy(header.magic, snapshot_magic, sizeof(snapshot_magic));
+	header.version = snapshot_version;
+	header.size = std::uint32_t(size);
+	header.vehicles = node.vehicles;
+	header.capacity = node.capacity;
+	std::memcpy(header.parameters, matrices.parameters, sizeof(header.parameters));
+
+	std::uint64_t bytes[number_of_blocks] = {
+		column, 2 * column, 2 * column, column, column,
+		stored[0] ? stored[0]->bytes() : 0,
+		stored[1] ? stored[1]->bytes() : 0,
+		stored[2] ? stored[2]->bytes() : 0,
+		matrices.time ? int_matrix : 0
+	};
+
+	std::uint64_t offset = align_block(sizeof(header));
+	for (auto i = 0; i < number_of_blocks; i++)
+	{
+		header.entry[i].bytes = bytes[i];
+		header.entry[i].offset = bytes[i] > 0 ? offset : 0;
+		offset = align_block(offset + bytes[i]);
+	}
+
+	for (auto m = 0; m < 3; m++)
+	{
+		if (stored[m] != nullptr)
+			header.entry[spatial_block + m].layout = std::uint32_t(stored[m]->get_layout());
+	}
+
+	const void* block[number_of_blocks] = {
+		node.id.data(), node.coord.data(), node.time_window.data(), node.demand.data(), node.service_time.data(),
+		stored[0] ? stored[0]->data() : nullptr,
+		stored[1] ? stored[1]->data() : nullptr,
+		stored[2] ? stored[2]->data() : nullptr,
+		nullptr
+	};
+	header.checksum = snapshot_checksum(header, block, [&matrices](int i)
+	{
+		return matrices.time->row(i);
+	});
+
+	std::ofstream output(file, std::ofstream::out | std::ofstream::trunc | std::ofstream::binary);
+	if (!output.is_open())
+		return false;
+
+	//writes the padding needed to reach the beginning of the next block
+	std::uint64_t written = 0;
+	auto write = [&output, &written](const void* data, std::uint64_t length)
+	{
+		output.write(static_cast<const char*>(data), length);
+		written += length;
+	};
+	auto pad = [&write, &written]()
+	{
+		static const char zero[block_alignment] = {};
+		write(zero, align_block(written) - written);
+	};
+
+	write(&header, sizeof(header));
+	pad();
+
+	write(node.id.data(), column);
+	pad();
+	write(node.coord.data(), 2 * column);
+	pad();
+	write(node.time_window.data(), 2 * column);
+	pad();
+	write(node.demand.data(), column);
+	pad();
+	write(node.service_time.data(), column);
+	pad();
+
+	for (auto m = 0; m < 3; m++)
+	{
+		if (stored[m] != nullptr)
+		{
+			write(stored[m]->data(), stored[m]->bytes());
+			pad();
+		}
+	}
+
+	if (matrices.time != nullptr)
+	{
+		for (auto i = 0; i < size; i++)
+			write(matrices.time->row(i), size * sizeof(std::int32_t));
+		pad();
+	}
+
+	return bool(output);
+}
+
+bool NodesSnapshot::open(const std::string& file, std::string& error)
+{
+	*this = NodesSnapshot();
+
+	if (!this->file.open(file))
+	{
+		error = "can not open file or file is empty";
+		return false;
+	}
+
+	if (this->file.size() < sizeof(snapshot_header))
+	{
+		error = "file is too small to be a snapshot";
+		this->file.close();
+		return false;
+	}
+
+	snapshot_header header;
+	std::memcpy(&header, this->file.data(), sizeof(header));
+
+	if (std::memcmp(header.magic, snapshot_magic, sizeof(snapshot_magic)) != 0)
+	{
+		error = "file is not a snapshot";
+		this->file.close();
+		return false;
+	}
+
+	if (header.version != snapshot_version)
+	{
+		error = "snapshot version " + std::to_string(header.version) + " is not supported";
+		this->file.close();
+		return false;
+	}
+
+	std::uint64_t size = header.size;
+	std::uint64_t expected[number_of_blocks] = {
+		size * 4, size * 8, size * 8, size * 4, size * 4,
+		0, 0, 0, size * size * 4
+	};
+
+	for (auto m = 0; m < 3; m++)
+	{
+		auto layout = header.entry[spatial_block + m].layout;
+		if (layout > std::uint32_t(matrix_layout::packed))
+		{
+			error = "snapshot matrix " + std::to_string(m) + " has an unknown layout";
+			this->file.close();
+			return false;
+		}
+		this->layouts[m] = matrix_layout(layout);
+		expected[spatial_block + m] = DistanceMatrix<double>::count(int(size), this->layouts[m]) * sizeof(double);
+	}
+
+	//every block must be either missing (only matrices) or complete and aligned
+	for (auto i = 0; i < number_of_blocks; i++)
+	{
+		auto& entry = header.entry[i];
+		bool optional = i >= spatial_block;
+
+		if (entry.bytes == 0 && optional)
+			continue;
+
+		if (entry.bytes != expected[i] || entry.offset % block_alignment != 0 || entry.offset + entry.bytes > this->file.size())
+		{
+			error = "snapshot block " + std::to_string(i) + " is corrupted";
+			this->file.close();
+			return false;
+		}
+	}
+
+	auto block = [this, &header](int i)
+	{
+		return header.entry[i].bytes == 0 ? nullptr : this->file.data() + header.entry[i].offset;
+	};
+
+	this->columns.size = int(size);
+	this->columns.vehicles = header.vehicles;
+	this->columns.capacity = header.capacity;
+	this->columns.id = reinterpret_cast<const int*>(block(id_block));
+	this->columns.coord = reinterpret_cast<const std::array<int, 2>*>(block(coord_block));
+	this->columns.time_window = reinterpret_cast<const std::array<int, 2>*>(block(time_window_block));
+	this->columns.demand = reinterpret_cast<const int*>(block(demand_block));
+	this->columns.service_time = reinterpret_cast<const int*>(block(service_time_block));
+
+	this->matrices[0] = reinterpret_cast<const double*>(block(spatial_block));
+	this->matrices[1] = reinterpret_cast<const double*>(block(temporal_block));
+	this->matrices[2] = reinterpret_cast<const double*>(block(spatio_temporal_block));
+	this->time = reinterpret_cast<const int*>(block(time_block));
+	std::memcpy(this->parameters, header.parameters, sizeof(this->parameters));
+
+	return true;
+}
+
+bool NodesSnapshot::verify(std::string& error) const
+{
+	if (!this->file.is_open())
+	{
+		error = "snapshot is not open";
+		return false;
+	}
+
+	snapshot_header header;
+	std::memcpy(&header, this->file.data(), sizeof(header));
+
+	const void* block[number_of_blocks];
+	for (auto i = 0; i < number_of_blocks; i++)
+		block[i] = this->file.data() + header.entry[i].offset;
+
+	auto time = this->time;
+	std::uint64_t size = header.size;
+	auto checksum = snapshot_checksum(header, block, [time, size](int i)
+	{
+		return time + i * size;
+	});
+
+	if (checksum != header.checksum)
+	{
+		error = "snapshot checksum does not match, the file is corrupted";
+		return false;
+	}
+
+	return true;
+}
+
+bool NodesSnapshot::is_open() const
+{
+	return this->file.is_open();
+}
+
+nodes_view NodesSnapshot::view() const
+{
+	return this->columns;
+}
+
+DistanceMatrix<double> NodesSnapshot::matrix(snapshot_matrix id) const
+{
+	int m = int(id);
+	if (id == snapshot_matrix::time || this->matrices[m] == nullptr)
+		return DistanceMatrix<double>();
+
+	return DistanceMatrix<double>(this->matrices[m], this->columns.size, this->layouts[m]);
+}
+
+const int* NodesSnapshot::time_matrix() const
+{
+	return this->time;
+}
+
+bool NodesSnapshot::same_parameters(double k1, double k2, double k3, double alpha1) const
+{
+	return this->matrices[1] != nullptr && this->matrices[2] != nullptr &&
+		this->parameters[0] == k1 && this->parameters[1] == k2 &&
+		this->parameters[2] == k3 && this->parameters[3] == alpha1;
+}
+
+int NodesSnapshot::get_size() const
+{
+	return this->columns.size;
+}
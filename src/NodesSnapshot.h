@@ -0,0 +1,144 @@
+#pragma once
+#include "NodesDistance.h"
+#include "MappedFile.h"
+#include "DistanceMatrix.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+* binary snapshot of a VRPTW instance
+*
+* A snapshot is written once from an initialized struct nodes and then memory-mapped.
+* It stores the columns of struct nodes and, optionally, the matrices computed from them,
+* every block starts on a 64 bytes boundary. Layout (native byte order):
+*
+* header: magic "VRPSNAP", version, number of nodes, vehicles, capacity,
+*         spatiotemporal parameters (k1, k2, k3, alpha1), checksum, offset and size of every block
+* blocks: id, coord (x, y pairs), time_window (ready, due pairs), demand, service_time,
+*         spatial, temporal and spatiotemporal matrices (double, full or packed layout),
+*         time matrix used by OrTools (int, row-major)
+*
+*/
+
+//optional blocks of a snapshot
+enum class snapshot_matrix
+{
+	spatial,
+	temporal,
+	spatio_temporal,
+	time
+};
+
+/**
+* matrices to be written in a snapshot. Missing matrices are left nullptr.
+* Classes that compute them fill this structure (see NodesDistance::add_to_snapshot, OrTools::add_to_snapshot)
+*
+* parameters: k1, k2, k3, alpha1 used for temporal and spatio_temporal
+*
+*/
+struct snapshot_matrices
+{
+	const DistanceMatrix<double>* spatial = nullptr;
+	const DistanceMatrix<double>* temporal = nullptr;
+	const DistanceMatrix<double>* spatio_temporal = nullptr;
+	const DistanceMatrix<int>* time = nullptr;
+	double parameters[4] = { 0.0, 0.0, 0.0, 0.0 };
+};
+
+/**
+* writes a snapshot, overrides files with the same name
+*
+* input:
+* file: file name as "name.extension"
+* node: reference to an initialized struct nodes
+* matrices: matrices stored together with the columns
+*
+* output:
+* true if the whole snapshot has been written
+*
+*/
+bool write_snapshot(const std::string& file, nodes& node, const snapshot_matrices& matrices);
+
+/**
+* read-only snapshot mapped in memory.
+* Views and matrices point into the mapping and are valid as long as the object exists
+*
+*/
+class NodesSnapshot
+{
+public:
+	NodesSnapshot() = default;
+
+	/**
+	* maps and validates a snapshot
+	*
+	* input:
+	* file: file name as "name.extension"
+	* error: reference to the string describing why the snapshot can not be used
+	*
+	* output:
+	* true if the snapshot can be used
+	*
+	*/
+	bool open(const std::string& file, std::string& error);
+
+	bool is_open() const;
+
+	/**
+	* checks the content of the whole file against the checksum written in the header.
+	* open only validates the structure, this function reads every block
+	*
+	* input:
+	* error: reference to the string describing why the check failed
+	*
+	* output:
+	* true if the content has not been changed since the snapshot was written
+	*
+	*/
+	bool verify(std::string& error) const;
+
+	/**
+	* columns of the instance
+	*
+	* output:
+	* view over the mapped columns, no copy is made
+	*
+	*/
+	nodes_view view() const;
+
+	/**
+	* stored matrix
+	*
+	* input:
+	* id: spatial, temporal or spatio_temporal
+	*
+	* output:
+	* matrix borrowed from the mapping with the layout it has been written with,
+	* empty matrix (size 0) if the snapshot does not contain it
+	*
+	*/
+	DistanceMatrix<double> matrix(snapshot_matrix id) const;
+
+	//row-major size x size time matrix used by OrTools, nullptr if the snapshot does not contain it
+	const int* time_matrix() const;
+
+	/**
+	* checks that temporal and spatio_temporal matrices have been computed with the given parameters
+	*
+	* output:
+	* true if both matrices are stored and parameters are equal
+	*
+	*/
+	bool same_parameters(double k1, double k2, double k3, double alpha1) const;
+
+	int get_size() const;
+
+private:
+	MappedFile file;
+	nodes_view columns;
+	const double* matrices[3] = { nullptr, nullptr, nullptr };
+	matrix_layout layouts[3] = { matrix_layout::full, matrix_layout::full, matrix_layout::full };
+	const int* time = nullptr;
+	double parameters[4] = { 0.0, 0.0, 0.0, 0.0 };
+};
@@ -0,0 +1,187 @@
+#include "OnDemandSpatioTemporal.h"
+#include "ParallelFor.h"
+#include <algorithm>
+#include <random>
+
+//distances computed at once by the row kernels, on the stack
+static const int chunk_size = 256;
+
+OnDemandSpatioTemporal::OnDemandSpatioTemporal(std::string file, bounds_estimate estimate, int samples) : NodesDistance::NodesDistance(file)
+{
+	this->init(estimate, samples);
+}
+
+OnDemandSpatioTemporal::OnDemandSpatioTemporal(nodes& node, bounds_estimate estimate, int samples) : NodesDistance::NodesDistance(node)
+{
+	this->init(estimate, samples);
+}
+
+OnDemandSpatioTemporal::OnDemandSpatioTemporal(std::string file, double k1, double k2, double k3, double alpha1, bounds_estimate estimate, int samples) : NodesDistance::NodesDistance(file)
+{
+	this->set_parameters(k1, k2, k3, alpha1);
+	this->init(estimate, samples);
+}
+
+OnDemandSpatioTemporal::OnDemandSpatioTemporal(nodes& node, double k1, double k2, double k3, double alpha1, bounds_estimate estimate, int samples) : NodesDistance::NodesDistance(node)
+{
+	this->set_parameters(k1, k2, k3, alpha1);
+	this->init(estimate, samples);
+}
+
+void OnDemandSpatioTemporal::set_parameters(double k1, double k2, double k3, double alpha1)
+{
+	if (k1 < k2 && k2 < k3)
+	{
+		this->k1 = k1;
+		this->k2 = k2;
+		this->k3 = k3;
+	}
+
+	if (alpha1 >= 0.0 && alpha1 <= 1.0)
+	{
+		this->alpha1 = alpha1;
+		this->alpha2 = 1.0 - alpha1;
+	}
+}
+
+void OnDemandSpatioTemporal::init(bounds_estimate estimate, int samples)
+{
+	this->x.resize(this->size);
+	this->y.resize(this->size);
+	this->ready.resize(this->size);
+	this->due.resize(this->size);
+	this->service.resize(this->size);
+
+	double max_width = 0;
+	for (auto i = 0; i < this->size; i++)
+	{
+		this->x[i] = this->node->coord[i][0];
+		this->y[i] = this->node->coord[i][1];
+		this->ready[i] = this->node->time_window[i][0];
+		this->due[i] = this->node->time_window[i][1];
+		this->service[i] = this->node->service_time[i];
+
+		auto width = this->node->time_window[i][1] - this->node->time_window[i][0];
+		if (i == 0 || width > max_width)
+			max_width = width;
+	}
+	this->parameters = { this->k1, this->k2, this->k3, max_width };
+
+	//first pair of customers excluding the depot, as SpatioTemporal
+	if (this->size <= 2)
+		return;
+
+	this->min_distance = this->max_distance = this->spatial_distance(1, 2);
+	this->min_time = this->max_time = temporal_pair(this->ready.data(), this->due.data(), this->service.data(), this->min_distance, 1, 2, this->parameters);
+
+	if (estimate == bounds_estimate::sampled)
+		this->sampled_bounds(samples);
+	else
+		this->exact_bounds();
+}
+
+void OnDemandSpatioTemporal::exact_bounds()
+{
+	//min and max found by a single thread, on its own cache line
+	struct alignas(64) bounds
+	{
+		double min_distance;
+		double max_distance;
+		double min_time;
+		double max_time;
+	};
+	std::vector<bounds> found(worker_count(), { this->min_distance, this->max_distance, this->min_time, this->max_time });
+
+	//a task is the upper part of a row, depot excluded. Longer rows come first
+	parallel_for(this->size - 2, [this, &found](int task, int worker)
+	{
+		auto i = task + 1;
+		auto& bound = found[worker];
+		double travel[chunk_size], temporal[chunk_size];
+
+		for (auto begin = i + 1; begin < this->size; begin += chunk_size)
+		{
+			auto end = std::min(begin + chunk_size, this->size);
+			euclidean_row(this->x.data(), this->y.data(), i, begin, end, travel, nullptr);
+			temporal_row(this->ready.data(), this->due.data(), this->service.data(), travel, i, begin, end, this->parameters, temporal);
+
+			for (auto j = 0; j < end - begin; j++)
+			{
+				bound.min_distance = std::min(bound.min_distance, travel[j]);
+				bound.max_distance = std::max(bound.max_distance, travel[j]);
+				bound.min_time = std::min(bound.min_time, temporal[j]);
+				bound.max_time = std::max(bound.max_time, temporal[j]);
+			}
+		}
+	});
+
+	for (auto& bound : found)
+	{
+		this->min_distance = std::min(this->min_distance, bound.min_distance);
+		this->max_distance = std::max(this->max_distance, bound.max_distance);
+		this->min_time = std::min(this->min_time, bound.min_time);
+		this->max_time = std::max(this->max_time, bound.max_time);
+	}
+}
+
+void OnDemandSpatioTemporal::sampled_bounds(int samples)
+{
+	//fixed seed, the same instance always gives the same bounds
+	std::mt19937_64 engine(5489u);
+	std::uniform_int_distribution<int> customer(1, this->size - 1);
+
+	for (auto sample = 0; sample < samples; sample++)
+	{
+		auto i = customer(engine);
+		auto j = customer(engine);
+		if (i == j)
+			continue;
+
+		auto travel = this->spatial_distance(i, j);
+		auto temporal = temporal_pair(this->ready.data(), this->due.data(), this->service.data(), travel, i, j, this->parameters);
+
+		this->min_distance = std::min(this->min_distance, travel);
+		this->max_distance = std::max(this->max_distance, travel);
+		this->min_time = std::min(this->min_time, temporal);
+		this->max_time = std::max(this->max_time, temporal);
+	}
+}
+
+void OnDemandSpatioTemporal::distance_row(int from_id, int begin, int end, double* distance) const
+{
+	double travel[chunk_size], temporal[chunk_size];
+
+	for (auto first = begin; first < end; first += chunk_size)
+	{
+		auto last = std::min(first + chunk_size, end);
+		euclidean_row(this->x.data(), this->y.data(), from_id, first, last, travel, nullptr);
+		temporal_row(this->ready.data(), this->due.data(), this->service.data(), travel, from_id, first, last, this->parameters, temporal);
+
+		for (auto j = first; j < last; j++)
+		{
+			distance[j - begin] = j == from_id ? 0.0 : this->scale(travel[j - first], temporal[j - first]);
+		}
+	}
+}
+
+double OnDemandSpatioTemporal::get_distance(int from_id, int to_id)
+{
+	return this->distance(from_id, to_id);
+}
+
+double OnDemandSpatioTemporal::get_spatial_distance(int from_id, int to_id)
+{
+	return this->spatial_distance(from_id, to_id);
+}
+
+double OnDemandSpatioTemporal::get_temporal_distance(int from_id, int to_id)
+{
+	if (from_id == to_id)
+		return 0.0;
+	return temporal_pair(this->ready.data(), this->due.data(), this->service.data(), this->spatial_distance(from_id, to_id), from_id, to_id, this->parameters);
+}
+
+std::size_t OnDemandSpatioTemporal::get_memory()
+{
+	return 5 * this->size * sizeof(double);
+}
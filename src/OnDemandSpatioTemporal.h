@@ -0,0 +1,131 @@
+#pragma once
+#include "NodesDistance.h"
+#include "DistanceKernels.h"
+#include <cmath>
+#include <vector>
+
+//how the scaling bounds of an OnDemandSpatioTemporal are found
+enum class bounds_estimate
+{
+	//streaming min and max over all pairs, no pair is stored. The distances are the same of SpatioTemporal
+	exact,
+
+	//min and max over a fixed number of random pairs, scaled values can be slightly out of [0; 1]
+	sampled
+};
+
+/**
+* NodesDistance's derived class
+* spatiotemporal distance (see SpatioTemporal) computed on demand, without matrices
+*
+* Only coordinates, time windows and service times are kept, about 40 bytes per customer instead of 24 * n,
+* so the spatiotemporal distance can be used on instances with tens of thousands of customers.
+* Every distance is computed when requested, distance_row computes many of them with the vectorized kernels.
+*
+*/
+class OnDemandSpatioTemporal final : public NodesDistance
+{
+public:
+	/**
+	* constructors from file or from struct nodes, with the default parameters of SpatioTemporal
+	*
+	* input
+	* file: file name as "name.extension"
+	* node: reference to an existing struct nodes
+	* estimate: how min and max spatial and temporal distances are found
+	* samples: number of random pairs used by bounds_estimate::sampled
+	*
+	*/
+	OnDemandSpatioTemporal(std::string file, bounds_estimate estimate = bounds_estimate::exact, int samples = 1 << 20);
+	OnDemandSpatioTemporal(nodes& node, bounds_estimate estimate = bounds_estimate::exact, int samples = 1 << 20);
+
+	/**
+	* constructors with the parameters of the distance
+	*
+	* input
+	* k1, k2, k3, alpha1: same as SpatioTemporal
+	* estimate, samples: same as above
+	*
+	*/
+	OnDemandSpatioTemporal(std::string file, double k1, double k2, double k3, double alpha1, bounds_estimate estimate = bounds_estimate::exact, int samples = 1 << 20);
+	OnDemandSpatioTemporal(nodes& node, double k1, double k2, double k3, double alpha1, bounds_estimate estimate = bounds_estimate::exact, int samples = 1 << 20);
+
+	/**
+	* implements NodesDistance's virtual function
+	*
+	* input:
+	* from_id: customer id
+	* to_id: customer id
+	*
+	* output:
+	* spatiotemporal distance between customer[from_id] and customer[to_id]
+	*
+	*/
+	double get_distance(int from_id, int to_id) override;
+
+	//non virtual version of get_distance (see Spatial::distance)
+	double distance(int from_id, int to_id) const
+	{
+		if (from_id == to_id)
+			return 0.0;
+
+		auto travel = this->spatial_distance(from_id, to_id);
+		auto temporal = temporal_pair(this->ready.data(), this->due.data(), this->service.data(), travel, from_id, to_id, this->parameters);
+		return this->scale(travel, temporal);
+	}
+
+	/**
+	* spatiotemporal distances between customer from_id and customers in [begin; end), computed with the vectorized kernels
+	*
+	* input:
+	* from_id: customer id
+	* begin, end: interval of customer ids
+	* distance: receives end - begin distances
+	*
+	*/
+	void distance_row(int from_id, int begin, int end, double* distance) const;
+
+	//Euclidean distance between customer[from_id] and customer[to_id]
+	double get_spatial_distance(int from_id, int to_id);
+
+	//temporal distance between customer[from_id] and customer[to_id]
+	double get_temporal_distance(int from_id, int to_id);
+
+	//memory of the per customer arrays
+	std::size_t get_memory() override;
+
+private:
+	void init(bounds_estimate estimate, int samples);
+	void set_parameters(double k1, double k2, double k3, double alpha1);
+
+	//exact bounds, every pair is computed once and discarded
+	void exact_bounds();
+	void sampled_bounds(int samples);
+
+	double spatial_distance(int from_id, int to_id) const
+	{
+		auto dx = this->x[from_id] - this->x[to_id];
+		auto dy = this->y[from_id] - this->y[to_id];
+		return std::sqrt(dx * dx + dy * dy);
+	}
+
+	//same expression used by SpatioTemporal
+	double scale(double spatial, double temporal) const
+	{
+		return this->alpha1 * (spatial - this->min_distance) / (this->max_distance - this->min_distance) +
+			this->alpha2 * (temporal - this->min_time) / (this->max_time - this->min_time);
+	}
+
+	double k1 = 1.0, k2 = 1.5, k3 = 2.0;
+	double alpha1 = 0.5, alpha2 = 1.0 - alpha1;
+	temporal_parameters parameters = { 1.0, 1.5, 2.0, 0.0 };
+
+	//scaling bounds, depot excluded
+	double max_time = 0;
+	double min_time = 0;
+	double max_distance = 0;
+	double min_distance = 0;
+
+	//coordinates, time windows and service times as structure of arrays
+	std::vector<double> x, y, ready, due, service;
+};
@@ -1,5 +1,10 @@
 #include "OrTools.h"
+#include "NodesSnapshot.h"
+#include "Instance.h"
 #include "ConsecutiveRandoms.h"
+#include "DistanceKernels.h"
+#include "TimeWindowTightening.h"
+#include "SubInstance.h"
 #include <iostream>
 #include <vector>
 #include <cmath>
@@ -30,37 +35,86 @@ void OrTools::write_solution(compact_solution& solution, std::string name)
 
 OrTools::OrTools(std::string file)
 {
-    init_nodes(this->node, file);
+    auto node = std::make_shared<nodes>();
+    init_nodes(*node, file);
+    this->node = node;
     init_time_matrix();
 }
 
 OrTools::OrTools(nodes& node)
 {
-    this->node = node;
+    this->node = std::make_shared<const nodes>(node);
     init_time_matrix();
 }
 
+OrTools::OrTools(NodesSnapshot& snapshot)
+{
+    auto node = std::make_shared<nodes>();
+    init_nodes(*node, snapshot.view());
+    this->node = node;
+
+    auto stored = snapshot.time_matrix();
+    if (stored == nullptr)
+    {
+        init_time_matrix();
+        return;
+    }
+
+    //the stored rows are read from the mapping, neither computed again nor copied
+    this->time_matrix = DistanceMatrix<int>(stored, snapshot.get_size(), matrix_layout::full);
+}
+
+OrTools::OrTools(std::shared_ptr<const Instance> instance)
+{
+    //both pointers share the ownership of the instance
+    this->node = std::shared_ptr<const nodes>(instance, &instance->get_nodes());
+    auto& time_matrix = instance->get_time_matrix();
+    this->time_matrix = DistanceMatrix<int>(time_matrix.data(), time_matrix.get_size(), matrix_layout::full, instance);
+}
+
+OrTools::OrTools(nodes& node, std::shared_ptr<const DistanceMatrix<int>> time_matrix)
+{
+    this->node = std::make_shared<const nodes>(node);
+    this->time_matrix = DistanceMatrix<int>(time_matrix->data(), time_matrix->get_size(), matrix_layout::full, time_matrix);
+}
+
+void OrTools::add_to_snapshot(snapshot_matrices& matrices)
+{
+    matrices.time = &this->time_matrix;
+}
+
+void OrTools::set_preprocessing(bool enabled)
+{
+    this->preprocessing = enabled;
+}
+
 void OrTools::init_time_matrix()
 {
-    auto size = this->node.id.size();
+    int size = this->node->id.size();
     this->time_matrix.resize(size);
 
+    //coordinates as structure of arrays, used by the batch kernels
+    std::vector<double> x(size), y(size);
+    for (int i = 0; i < size; i++)
+    {
+        x[i] = this->node->coord[i][0];
+        y[i] = this->node->coord[i][1];
+    }
+
     //travel time as Euclidian distance. The values ar rounded to the nearer integer
     for (int i = 0; i < size; i++)
     {
-        for (int j = 0; j < size; j++)
-        {
-            this->time_matrix[i].push_back(std::sqrt(std::pow(this->node.coord[i][0] - this->node.coord[j][0], 2) + std::pow(this->node.coord[i][1] - this->node.coord[j][1], 2) + 0.5));
-        }
+        euclidean_row(x.data(), y.data(), i, 0, size, nullptr, this->time_matrix.row(i));
     }
 }
 
 compact_solution OrTools::solve_problem()
 {
     //create index manager and model used by Google Or-tools
-    RoutingIndexManager manager(time_matrix.size(), this->node.vehicles, this->depot);
+    SubInstance whole(*this->node);
+    RoutingIndexManager manager(this->time_matrix.get_size(), this->node->vehicles, this->depot);
     RoutingModel routing(manager);
-    this->set_constraints(this->time_matrix, this->node, manager, routing);
+    this->set_constraints(this->time_matrix, whole, manager, routing);
 
     // Setting first solution heuristic.
     RoutingSearchParameters searchParameters = DefaultRoutingSearchParameters();
@@ -70,31 +124,21 @@ compact_solution OrTools::solve_problem()
     // Solve the problem.
     const Assignment* solution = routing.SolveWithParameters(searchParameters);
 
-    return this->readable_solution(this->node, manager, routing, *solution);
+    return this->readable_solution(whole, manager, routing, *solution);
 }
 
 compact_solution OrTools::solve_sub_problem(std::vector<int> &sub_id)
 {
-    //initialize sub_problem structure
-    nodes sub_node;
-    init_sub_nodes(this->node, sub_node, sub_id);
-    auto size = sub_node.id.size();
-    sub_node.vehicles = std::max(int(1.2*size / (this->node.id.size() / this->node.vehicles)), int(2*this->node.id.size()/this->node.vehicles));
-
-    std::vector<std::vector<int>> sub_time_matrix(size, std::vector<int>(size));
-    for (int i = 0; i < size; i++)
-    {
-        for (int j = 0; j < size; j++)
-        {
-            sub_time_matrix[i][j] = this->time_matrix[sub_node.id[i]][sub_node.id[j]];
-        }
-    }
+    //view over the sub-problem, columns and travel times are read from the whole problem without copies
+    SubInstance sub_node(*this->node, sub_id);
+    auto size = sub_node.get_size();
+    sub_node.set_vehicles(std::max(int(1.2*size / (this->node->id.size() / this->node->vehicles)), int(2*this->node->id.size()/this->node->vehicles)));
 
     //same as in solve_problem() using sub_problem data
-    RoutingIndexManager manager(sub_time_matrix.size(), sub_node.vehicles, this->depot);
+    RoutingIndexManager manager(size, sub_node.get_vehicles(), this->depot);
     RoutingModel routing(manager);
     
-    this->set_constraints(sub_time_matrix, sub_node, manager, routing);
+    this->set_constraints(this->time_matrix, sub_node, manager, routing);
     
     // Setting first solution heuristic.
     RoutingSearchParameters searchParameters = DefaultRoutingSearchParameters();
@@ -110,9 +154,10 @@ compact_solution OrTools::solve_sub_problem(std::vector<int> &sub_id)
 
 compact_solution OrTools::solve_problem_solution(std::vector<std::vector<int>> &routes)
 {
-    RoutingIndexManager manager(this->time_matrix.size(), this->node.vehicles, this->depot);
+    SubInstance whole(*this->node);
+    RoutingIndexManager manager(this->time_matrix.get_size(), this->node->vehicles, this->depot);
     RoutingModel routing(manager);
-    this->set_constraints(this->time_matrix, this->node, manager, routing);
+    this->set_constraints(this->time_matrix, whole, manager, routing);
 
     //conversion from int to int64. Or Tools can not use the given solution otherwise
     std::vector<std::vector<int64>> converted_routes(routes.size(), std::vector<int64>());
@@ -135,41 +180,95 @@ compact_solution OrTools::solve_problem_solution(std::vector<std::vector<int>> &
     // Solve the problem using the initial solution
     const Assignment* solution = routing.SolveFromAssignmentWithParameters(initial_solution, searchParameters);
 
-    return this->readable_solution(node, manager, routing, *solution);
+    return this->readable_solution(whole, manager, routing, *solution);
 }
 
-void OrTools::set_constraints(std::vector<std::vector<int>>& time_matrix, nodes& node, RoutingIndexManager& manager, RoutingModel& routing)
+void OrTools::set_constraints(const DistanceMatrix<int>& time_matrix, const SubInstance& node, RoutingIndexManager& manager, RoutingModel& routing)
 {
+    //transit and demand of every routing index computed once, the callbacks are called millions of times by the
+    //local search and only read a flat array. Travel times are read from the matrix of the whole problem through the positions of the view.
+    //The manager gives the first size indices to the nodes of the problem, the other ones are the starts and ends
+    //of the vehicles, copies of the depot: only the size x size block is stored, the copies read the row and column of the depot
+    auto indices = manager.num_indices();
+    auto size = node.get_size();
+    auto transit = std::make_shared<std::vector<int64>>(std::size_t(size) * size);
+    auto demand = std::make_shared<std::vector<int64>>(indices);
+    for (int from_index = 0; from_index < size; from_index++)
+    {
+        auto from_node = manager.IndexToNode(from_index).value();
+        auto source = time_matrix.row(node.position(from_node));
+        auto service = node.service_time(from_node);
+        auto row = transit->data() + std::size_t(from_index) * size;
+        for (int to_index = 0; to_index < size; to_index++)
+        {
+            row[to_index] = source[node.position(manager.IndexToNode(to_index).value())] + service;
+        }
+    }
+    for (int index = 0; index < indices; index++)
+    {
+        (*demand)[index] = node.demand(manager.IndexToNode(index).value());
+    }
+
     //set arc cost between customers as travel_time + service_time
+    int64 depot_index = manager.NodeToIndex(this->depot);
     const int transit_callback_index = routing.RegisterTransitCallback(
-        [&time_matrix, &node, &manager](int64 from_index, int64 to_index) -> int64 {
-            auto from_node = manager.IndexToNode(from_index).value();
-            auto to_node = manager.IndexToNode(to_index).value();
-            return time_matrix[from_node][to_node] + node.service_time[from_node];
+        [transit, size, depot_index](int64 from_index, int64 to_index) -> int64 {
+            auto from = from_index < size ? from_index : depot_index;
+            auto to = to_index < size ? to_index : depot_index;
+            return (*transit)[std::size_t(from) * size + to];
         });
 
     routing.SetArcCostEvaluatorOfAllVehicles(transit_callback_index);
 
+    //preprocessing (see set_preprocessing): time windows of the positions of the view tightened without copies of the
+    //sub-problem, routes end by the depot due date
+    std::vector<long long> ready, due;
+    int64 horizon = 30000000;
+    if (this->preprocessing)
+    {
+        tighten_time_windows(node, time_matrix, ready, due);
+        horizon = node.time_window(0)[1];
+
+        //customer j can not follow customer i if it is reached after its due date leaving i as soon as possible (as in
+        //CompatibilityIndex), or if their demands exceed the capacity. The same travel times of the transit callback are used,
+        //the depot keeps all its arcs
+        for (int i = 1; i < node.get_size(); i++)
+        {
+            auto next = routing.NextVar(manager.NodeToIndex(RoutingIndexManager::NodeIndex(i)));
+            auto source = time_matrix.row(node.position(i));
+            auto earliest = ready[i] + node.service_time(i);
+            for (int j = 1; j < node.get_size(); j++)
+            {
+                if (i != j && (earliest + source[node.position(j)] > due[j] || node.demand(i) + node.demand(j) > node.get_capacity()))
+                    next->RemoveValue(manager.NodeToIndex(RoutingIndexManager::NodeIndex(j)));
+            }
+        }
+    }
+
     std::string time{ "Time" };
     routing.AddDimension(transit_callback_index,  // transit callback index
-        int64{ 30000000 },                        // allow waiting time (high value means that a vehicle can stay as lons as necessary)
-        int64{ 30000000 },                        // maximum time per vehicle (high value means that there is no maximum time)
+        horizon,                                  // allow waiting time (without preprocessing a high value means that a vehicle can stay as lons as necessary)
+        horizon,                                  // maximum time per vehicle (without preprocessing a high value means that there is no maximum time)
         false,                                    // Don't force start cumul to zero (vehicles departure is not forced to be at time 0)
         time);
     const RoutingDimension& time_dimension = routing.GetDimensionOrDie(time);
+
     // Add time window constraints for each location except depot.
-    for (int i = 1; i < node.time_window.size(); ++i) {
+    for (int i = 1; i < node.get_size(); ++i) {
         int64 index = manager.NodeToIndex(RoutingIndexManager::NodeIndex(i));
-        time_dimension.CumulVar(index)->SetRange(node.time_window[i][0],
-            node.time_window[i][1]);
+        if (this->preprocessing)
+            time_dimension.CumulVar(index)->SetRange(ready[i], due[i]);
+        else
+            time_dimension.CumulVar(index)->SetRange(node.time_window(i)[0],
+                node.time_window(i)[1]);
     }
     // Add time window constraints for each vehicle start node.
-    for (int i = 0; i < node.vehicles; ++i) {
+    for (int i = 0; i < node.get_vehicles(); ++i) {
         int64 index = routing.Start(i);
-        time_dimension.CumulVar(index)->SetRange(node.time_window[0][0],
-            node.time_window[0][1]);
+        time_dimension.CumulVar(index)->SetRange(node.time_window(0)[0],
+            node.time_window(0)[1]);
     }
-    for (int i = 0; i < node.vehicles; ++i) {
+    for (int i = 0; i < node.get_vehicles(); ++i) {
         routing.AddVariableMinimizedByFinalizer(
             time_dimension.CumulVar(routing.Start(i)));
         routing.AddVariableMinimizedByFinalizer(
@@ -178,13 +277,12 @@ void OrTools::set_constraints(std::vector<std::vector<int>>& time_matrix, nodes&
 
     //set demand as customer's demand
     const int demand_callback_index = routing.RegisterUnaryTransitCallback(
-        [&node, &manager](int64 from_index) -> int64 {
-            int from_node = manager.IndexToNode(from_index).value();
-            return node.demand[from_node];
+        [demand](int64 from_index) -> int64 {
+            return (*demand)[from_index];
         });
 
     // Add vehicle capacity constraint
-    std::vector<int64> cap(node.vehicles, node.capacity);
+    std::vector<int64> cap(node.get_vehicles(), node.get_capacity());
     routing.AddDimensionWithVehicleCapacity(
         demand_callback_index,
         int64{ 0 },
@@ -194,7 +292,7 @@ void OrTools::set_constraints(std::vector<std::vector<int>>& time_matrix, nodes&
         "Capacity");
 
     // Instantiate route start and end times to produce feasible times.
-    for (int i = 0; i < node.vehicles; ++i) {
+    for (int i = 0; i < node.get_vehicles(); ++i) {
         routing.AddVariableMinimizedByFinalizer(
             time_dimension.CumulVar(routing.Start(i)));
         routing.AddVariableMinimizedByFinalizer(
@@ -203,7 +301,7 @@ void OrTools::set_constraints(std::vector<std::vector<int>>& time_matrix, nodes&
 
 }
 
-compact_solution OrTools::readable_solution(nodes& node, const RoutingIndexManager& manager, const RoutingModel& routing, const Assignment& solution)
+compact_solution OrTools::readable_solution(const SubInstance& node, const RoutingIndexManager& manager, const RoutingModel& routing, const Assignment& solution)
 {
     compact_solution c_solution;
 
@@ -215,7 +313,7 @@ compact_solution OrTools::readable_solution(nodes& node, const RoutingIndexManag
         return c_solution;
     }
     
-    for (int vehicle_id = 0; vehicle_id < node.vehicles; ++vehicle_id)
+    for (int vehicle_id = 0; vehicle_id < node.get_vehicles(); ++vehicle_id)
     {
         int64 index = routing.Start(vehicle_id);
         bool not_empty = false;
@@ -235,7 +333,7 @@ compact_solution OrTools::readable_solution(nodes& node, const RoutingIndexManag
         while (!routing.IsEnd(index))
         {
             int node_index = manager.IndexToNode(index).value();
-            c_solution.routes[c_solution.number_vehicles].push_back(node.id[node_index]);
+            c_solution.routes[c_solution.number_vehicles].push_back(node.id(node_index));
             auto time_var = time_dimension.CumulVar(index);
             index = solution.Value(routing.NextVar(index));
         }
@@ -1,6 +1,8 @@
 #pragma warning(disable : 4996)
 #pragma once
 #include "NodesDistance.h"
+#include "DistanceMatrix.h"
+#include "SubInstance.h"
 #include "ortools/constraint_solver/routing.h"
 #include "ortools/constraint_solver/routing_enums.pb.h"
 #include "ortools/constraint_solver/routing_index_manager.h"
@@ -46,6 +48,36 @@ public:
 	OrTools(std::string file);
 	OrTools(nodes& node);
 
+	/**
+	* constructor from snapshot. The stored time matrix is borrowed from the mapping if available, computed otherwise.
+	* The columns of the nodes are copied (O(n), as in NodesDistance), the snapshot must outlive this object
+	*
+	* input:
+	* snapshot: reference to an opened NodesSnapshot
+	*
+	*/
+	OrTools(NodesSnapshot& snapshot);
+
+	/**
+	* constructor from a shared instance, nodes and time matrix are borrowed without copies.
+	* Many solvers (also on different threads) can share the same instance
+	*
+	* input:
+	* instance: instance shared with other objects, kept alive by this object
+	*
+	*/
+	OrTools(std::shared_ptr<const Instance> instance);
+
+	/**
+	* constructor with travel times computed elsewhere, e.g. on a road network (see RoadDistance::get_time_matrix)
+	*
+	* input:
+	* node: reference to an already initialized struct nodes
+	* time_matrix: square matrix of travel times between customers (full layout), shared without copies
+	*
+	*/
+	OrTools(nodes& node, std::shared_ptr<const DistanceMatrix<int>> time_matrix);
+
 	/*
 	* solve problem based on the struct nodes initialized during construction
 	* 
@@ -88,20 +120,48 @@ public:
 	* 
 	*/
 	void static write_solution(compact_solution& solution, std::string name);
+
+	/**
+	* adds the time matrix to the ones written in a snapshot (see write_snapshot)
+	*
+	* input:
+	* matrices: reference to the structure passed to write_snapshot, must not outlive this object
+	*
+	*/
+	void add_to_snapshot(snapshot_matrices& matrices);
+
+	/**
+	* preprocessing of the next solved problems, off by default:
+	* - time windows are tightened with travel and service times (see tighten_time_windows)
+	* - waiting and route times are limited by the depot due date, routes must end by it
+	* - arcs between customers that can not follow each other because of their time windows (see CompatibilityIndex)
+	*	or whose demands exceed the capacity are removed from the model
+	* Smaller domains speed up both the first solution and the local search
+	*
+	* input:
+	* enabled: true to preprocess the problems
+	*
+	*/
+	void set_preprocessing(bool enabled);
 	
 private:
-	nodes node;
+	//owned or borrowed from an Instance, never modified after construction
+	std::shared_ptr<const nodes> node;
 
-	//square matrix that contains travel time between customers. If vehicles speed is considered to be 1 and constant, travel time is equal to the distance
-	std::vector<std::vector<int>> time_matrix;
+	//square matrix (full layout) that contains travel time between customers. If vehicles speed is considered to be 1 and constant, travel time is equal to the distance.
+	//Owned, or borrowed from an Instance, a RoadDistance or a snapshot
+	DistanceMatrix<int> time_matrix;
 
 	void init_time_matrix();
 
+	bool preprocessing = false;
+
 	//depot's index is always 0 
 	const operations_research::RoutingIndexManager::NodeIndex depot{ 0 };
 
-	void set_constraints(std::vector<std::vector<int>>& time_matrix, nodes& node, operations_research::RoutingIndexManager& manager, operations_research::RoutingModel& routing);
+	//time_matrix contains the travel times of the whole problem, node is the solved (sub-)problem
+	void set_constraints(const DistanceMatrix<int>& time_matrix, const SubInstance& node, operations_research::RoutingIndexManager& manager, operations_research::RoutingModel& routing);
 
 	//summarize the solution given by the solver in a struct compact_solution
-	compact_solution readable_solution(nodes& node, const operations_research::RoutingIndexManager& manager, const operations_research::RoutingModel& routing, const operations_research::Assignment& solution);
+	compact_solution readable_solution(const SubInstance& node, const operations_research::RoutingIndexManager& manager, const operations_research::RoutingModel& routing, const operations_research::Assignment& solution);
 };
\ No newline at end of file
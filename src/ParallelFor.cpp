@@ -0,0 +1,35 @@
+#include "ParallelFor.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+inline int worker_count()
+{
+	auto count = int(std::thread::hardware_concurrency());
+	return count > 0 ? count : 1;
+}
+
+template<class Function>
+void parallel_for(int tasks, Function function, int workers)
+{
+	if (workers <= 0)
+		workers = worker_count();
+	if (workers > tasks)
+		workers = tasks;
+
+	std::atomic<int> next(0);
+	auto work = [&next, &function, tasks](int worker)
+	{
+		for (auto task = next++; task < tasks; task = next++)
+			function(task, worker);
+	};
+
+	std::vector<std::thread> threads;
+	for (auto worker = 1; worker < workers; worker++)
+		threads.emplace_back(work, worker);
+
+	work(0);
+
+	for (auto& thread : threads)
+		thread.join();
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+/**
+* number of threads used by parallel_for
+*
+* output:
+* number of hardware threads, at least 1
+*
+*/
+int worker_count();
+
+/**
+* runs function(task, worker) for every task in [0; tasks) using worker_count() threads,
+* the calling thread is one of them. Tasks are handed out in increasing order to the first
+* free worker, so expensive tasks should have the lowest numbers.
+* Returns when all tasks are done.
+*
+* input:
+* tasks: number of tasks
+* function: callable as function(int task, int worker), worker is in [0; workers) and
+*			can be used to index per-thread data
+* workers: number of threads, 0 means worker_count()
+*
+*/
+template<class Function>
+void parallel_for(int tasks, Function function, int workers = 0);
+
+//needed because otherwise the template is not usable in the header file
+#include "ParallelFor.cpp"
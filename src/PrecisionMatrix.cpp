@@ -0,0 +1,89 @@
+#include "PrecisionMatrix.h"
+#include <cmath>
+#include <utility>
+
+PrecisionMatrix::PrecisionMatrix(DistanceMatrix<double> matrix)
+{
+	this->f64 = std::move(matrix);
+}
+
+void PrecisionMatrix::resize(int size, matrix_layout layout, matrix_precision precision, double min_value, double max_value)
+{
+	this->precision = precision;
+	this->f64 = DistanceMatrix<double>();
+	this->f32 = DistanceMatrix<float>();
+	this->u16 = DistanceMatrix<std::uint16_t>();
+	this->offset = 0.0;
+	this->scale = 1.0;
+
+	switch (precision)
+	{
+	case matrix_precision::f32:
+		this->f32.resize(size, layout);
+		break;
+	case matrix_precision::u16:
+		this->u16.resize(size, layout);
+
+		//one step is left for the rounding of the offset
+		if (max_value > min_value)
+			this->scale = (max_value - min_value) / 65534.0;
+
+		//a negative minimum is lowered to a multiple of the scale, so 0 (distance of a customer from itself) is stored exactly.
+		//Otherwise the offset is the minimum itself, 0 is stored exactly only when it is the minimum (as for the ranges of SpatioTemporal)
+		this->offset = min_value < 0.0 ? -std::ceil(-min_value / this->scale) * this->scale : min_value;
+		break;
+	default:
+		this->f64.resize(size, layout);
+	}
+}
+
+const DistanceMatrix<double>& PrecisionMatrix::get_double() const
+{
+	return this->f64;
+}
+
+DistanceMatrix<double>& PrecisionMatrix::get_double()
+{
+	return this->f64;
+}
+
+std::size_t PrecisionMatrix::bytes() const
+{
+	return this->f64.bytes() + this->f32.bytes() + this->u16.bytes();
+}
+
+int PrecisionMatrix::get_size() const
+{
+	switch (this->precision)
+	{
+	case matrix_precision::f32:
+		return this->f32.get_size();
+	case matrix_precision::u16:
+		return this->u16.get_size();
+	default:
+		return this->f64.get_size();
+	}
+}
+
+matrix_layout PrecisionMatrix::get_layout() const
+{
+	switch (this->precision)
+	{
+	case matrix_precision::f32:
+		return this->f32.get_layout();
+	case matrix_precision::u16:
+		return this->u16.get_layout();
+	default:
+		return this->f64.get_layout();
+	}
+}
+
+matrix_precision PrecisionMatrix::get_precision() const
+{
+	return this->precision;
+}
+
+double PrecisionMatrix::get_scale() const
+{
+	return this->scale;
+}
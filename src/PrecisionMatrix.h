@@ -0,0 +1,252 @@
+#pragma once
+#include "DistanceMatrix.h"
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+//precisions available for a PrecisionMatrix
+enum class matrix_precision
+{
+	//double, values are exact
+	f64,
+
+	//float, relative error about 6e-8, half of the memory
+	f32,
+
+	//16 bits integers scaled over the range of the values, absolute error up to (max - min) / 131068, a quarter of the memory
+	u16
+};
+
+/**
+* read-only values of a PrecisionMatrix stored as T (double, float or std::uint16_t), see PrecisionMatrix::visit.
+* The precision is part of the type, so get has no branch on it and can be inlined in the loops of the distance policies
+*
+*/
+template<class T>
+class TypedMatrix
+{
+public:
+	using value_type = T;
+
+	/**
+	* constructor
+	*
+	* input:
+	* values: stored values, must outlive this object
+	* offset, scale: values are offset + stored * scale, used only by std::uint16_t
+	*
+	*/
+	explicit TypedMatrix(const DistanceMatrix<T>& values, double offset = 0.0, double scale = 1.0) : values(&values), offset(offset), scale(scale)
+	{
+	}
+
+	//value in [from_id][to_id], same of PrecisionMatrix::get
+	double get(int from_id, int to_id) const
+	{
+		if constexpr (std::is_same<T, std::uint16_t>::value)
+			return this->offset + this->values->get(from_id, to_id) * this->scale;
+		else
+			return this->values->get(from_id, to_id);
+	}
+
+private:
+	const DistanceMatrix<T>* values;
+	double offset;
+	double scale;
+};
+
+/**
+* symmetric DistanceMatrix whose values are stored as double, float or scaled 16 bits integers.
+* Values are always read and written as double, the conversion is made by get and set.
+*
+* Partitioning algorithms only compare distances, reduced precisions keep more customers in memory
+* and in cache at the cost of a small rounding of the values
+*
+*/
+class PrecisionMatrix
+{
+public:
+	PrecisionMatrix() = default;
+
+	//wraps a double matrix, owned or borrowed (e.g. from a NodesSnapshot)
+	PrecisionMatrix(DistanceMatrix<double> matrix);
+
+	/**
+	* discards the actual values and allocates an owned matrix with values set to 0
+	*
+	* input:
+	* size: number of rows and columns
+	* layout: full or packed
+	* precision: type used to store the values
+	* min_value, max_value: range of the values to be stored, used only by u16.
+	*						The range should contain 0, otherwise 0 can not be stored exactly
+	*
+	*/
+	void resize(int size, matrix_layout layout, matrix_precision precision, double min_value = 0.0, double max_value = 0.0);
+
+	/**
+	* computes a symmetric matrix a row at a time. With u16 rows are computed twice, the first time to find the range
+	*
+	* input:
+	* size, layout, precision: same as resize
+	* row: callable as row(int i, double* values), writes the values [i][i], ..., [i][size - 1]
+	*
+	*/
+	template<class Row>
+	void compute_symmetric(int size, matrix_layout layout, matrix_precision precision, Row row)
+	{
+		std::vector<double> values(size);
+		double max_value = 0.0;
+
+		if (precision == matrix_precision::u16)
+		{
+			for (auto i = 0; i < size; i++)
+			{
+				row(i, values.data());
+				for (auto j = 0; j < size - i; j++)
+				{
+					if (values[j] > max_value)
+						max_value = values[j];
+				}
+			}
+		}
+
+		this->resize(size, layout, precision, 0.0, max_value);
+
+		for (auto i = 0; i < size; i++)
+		{
+			row(i, values.data());
+			for (auto j = i; j < size; j++)
+			{
+				this->set_symmetric(i, j, values[j - i]);
+			}
+		}
+	}
+
+	//value in [from_id][to_id]
+	double get(int from_id, int to_id) const
+	{
+		switch (this->precision)
+		{
+		case matrix_precision::f32:
+			return this->f32.get(from_id, to_id);
+		case matrix_precision::u16:
+			return this->offset + this->u16.get(from_id, to_id) * this->scale;
+		default:
+			return this->f64.get(from_id, to_id);
+		}
+	}
+
+	/**
+	* calls function with the values read with the actual precision, checked once instead of at every get
+	*
+	* input:
+	* function: callable as function(const TypedMatrix<T>& values) for T double, float and std::uint16_t
+	*
+	* output:
+	* value returned by function
+	*
+	*/
+	template<class Function>
+	decltype(auto) visit(Function&& function) const
+	{
+		switch (this->precision)
+		{
+		case matrix_precision::f32:
+			return function(TypedMatrix<float>(this->f32));
+		case matrix_precision::u16:
+			return function(TypedMatrix<std::uint16_t>(this->u16, this->offset, this->scale));
+		default:
+			return function(TypedMatrix<double>(this->f64));
+		}
+	}
+
+	/**
+	* values read as T, the precision of the matrix must be the one of T
+	*
+	* output:
+	* same values given to visit
+	*
+	*/
+	template<class T>
+	TypedMatrix<T> typed() const
+	{
+		if constexpr (std::is_same<T, float>::value)
+			return TypedMatrix<float>(this->f32);
+		else if constexpr (std::is_same<T, std::uint16_t>::value)
+			return TypedMatrix<std::uint16_t>(this->u16, this->offset, this->scale);
+		else
+			return TypedMatrix<double>(this->f64);
+	}
+
+	//sets both [from_id][to_id] and [to_id][from_id] of an owned matrix, the value is rounded to the precision
+	void set_symmetric(int from_id, int to_id, double value)
+	{
+		switch (this->precision)
+		{
+		case matrix_precision::f32:
+			this->f32.set_symmetric(from_id, to_id, float(value));
+			break;
+		case matrix_precision::u16:
+			this->u16.set_symmetric(from_id, to_id, this->quantize(value));
+			break;
+		default:
+			this->f64.set_symmetric(from_id, to_id, value);
+		}
+	}
+
+	void set(int from_id, int to_id, double value)
+	{
+		switch (this->precision)
+		{
+		case matrix_precision::f32:
+			this->f32.set(from_id, to_id, float(value));
+			break;
+		case matrix_precision::u16:
+			this->u16.set(from_id, to_id, this->quantize(value));
+			break;
+		default:
+			this->f64.set(from_id, to_id, value);
+		}
+	}
+
+	//stored matrix when the precision is f64, an empty matrix otherwise
+	const DistanceMatrix<double>& get_double() const;
+	DistanceMatrix<double>& get_double();
+
+	//memory used by the values in bytes
+	std::size_t bytes() const;
+
+	int get_size() const;
+
+	matrix_layout get_layout() const;
+
+	matrix_precision get_precision() const;
+
+	//step between consecutive u16 values (1 for other precisions)
+	double get_scale() const;
+
+private:
+	std::uint16_t quantize(double value) const
+	{
+		auto steps = (value - this->offset) / this->scale;
+
+		//values out of range (and NaN) are clamped
+		if (!(steps > 0.0))
+			return 0;
+		if (steps > 65535.0)
+			return 65535;
+		return std::uint16_t(steps + 0.5);
+	}
+
+	matrix_precision precision = matrix_precision::f64;
+
+	//only the matrix of the actual precision is allocated
+	DistanceMatrix<double> f64;
+	DistanceMatrix<float> f32;
+	DistanceMatrix<std::uint16_t> u16;
+
+	//u16 values are offset + stored * scale
+	double offset = 0.0;
+	double scale = 1.0;
+};
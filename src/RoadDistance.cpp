@@ -0,0 +1,81 @@
+#include "RoadDistance.h"
+#include "Instance.h"
+#include <algorithm>
+
+RoadDistance::RoadDistance(std::string file, const RoadGraph& graph, int workers) : NodesDistance::NodesDistance(file)
+{
+	this->init(graph, workers);
+}
+
+RoadDistance::RoadDistance(nodes& node, const RoadGraph& graph, int workers) : NodesDistance::NodesDistance(node)
+{
+	this->init(graph, workers);
+}
+
+RoadDistance::RoadDistance(std::shared_ptr<const Instance> instance, const RoadGraph& graph, int workers) : NodesDistance::NodesDistance(instance)
+{
+	this->init(graph, workers);
+}
+
+void RoadDistance::init(const RoadGraph& graph, int workers)
+{
+	this->graph_node.resize(this->size);
+	for (auto i = 0; i < this->size; i++)
+	{
+		this->graph_node[i] = graph.snap(this->node->coord[i][0], this->node->coord[i][1]);
+	}
+
+	//customers are both sources and targets of the table
+	auto times = graph.many_to_many(this->graph_node, this->graph_node, workers);
+
+	auto time_matrix = std::make_shared<DistanceMatrix<int>>(this->size);
+	for (auto i = 0; i < this->size; i++)
+	{
+		for (auto j = 0; j < this->size; j++)
+		{
+			auto time = times[std::size_t(i) * this->size + j];
+			if (i != j && time >= unreachable_time)
+			{
+				this->unreachable++;
+				time = unreachable_time;
+			}
+			time_matrix->set(i, j, int(time));
+		}
+	}
+
+	this->road_matrix.resize(this->size, matrix_layout::packed);
+	for (auto i = 0; i < this->size; i++)
+	{
+		for (auto j = i; j < this->size; j++)
+		{
+			this->road_matrix.set_symmetric(i, j, (time_matrix->get(i, j) + time_matrix->get(j, i)) / 2.0);
+		}
+	}
+
+	this->time_matrix = time_matrix;
+}
+
+double RoadDistance::get_distance(int from_id, int to_id)
+{
+	return this->distance(from_id, to_id);
+}
+
+std::shared_ptr<const DistanceMatrix<int>> RoadDistance::get_time_matrix() const
+{
+	return this->time_matrix;
+}
+
+const std::vector<int>& RoadDistance::get_graph_nodes() const
+{
+	return this->graph_node;
+}
+
+int RoadDistance::get_unreachable() const
+{
+	return this->unreachable;
+}
+
+std::size_t RoadDistance::get_memory()
+{
+	return this->road_matrix.bytes() + std::size_t(this->size) * this->size * sizeof(int);
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include "NodesDistance.h"
+#include "DistanceMatrix.h"
+#include "RoadGraph.h"
+#include <memory>
+#include <vector>
+
+/**
+* NodesDistance's derived class
+* distance is implemented as travel time on a road network (see RoadGraph)
+*
+* Every customer is snapped to its nearest graph node and the whole customer time matrix is computed
+* with the bucket queries of the contraction hierarchy. Road times are not symmetric: the directed
+* times are kept for OrTools (get_time_matrix), the partitioners use the mean of the two directions.
+* Customers snapped to the same node are at distance 0, the time to reach the node is not counted.
+*
+*/
+class RoadDistance final : public NodesDistance
+{
+public:
+	/**
+	* constructors from file, from struct nodes and from a shared instance
+	*
+	* input
+	* file: file name as "name.extension"
+	* node: reference to an existing struct nodes
+	* instance: instance shared with other objects, its nodes are borrowed
+	* graph: contracted road graph with coordinates in the system of the instance, needed only during the construction
+	* workers: number of threads used by the queries, 0 means all the available ones
+	*
+	*/
+	RoadDistance(std::string file, const RoadGraph& graph, int workers = 0);
+	RoadDistance(nodes& node, const RoadGraph& graph, int workers = 0);
+	RoadDistance(std::shared_ptr<const Instance> instance, const RoadGraph& graph, int workers = 0);
+
+	/**
+	* implements NodesDistance's virtual function
+	*
+	* input:
+	* from_id: customer id
+	* to_id: customer id
+	*
+	* output:
+	* mean road travel time between customer[from_id] and customer[to_id] in the two directions
+	*
+	*/
+	double get_distance(int from_id, int to_id) override;
+
+	//non virtual version of get_distance (see Spatial::distance)
+	double distance(int from_id, int to_id) const
+	{
+		return this->road_matrix.get(from_id, to_id);
+	}
+
+	/**
+	* directed travel times between customers, rounded to int as the time matrix of OrTools.
+	* Pairs without a road path have unreachable_time
+	*
+	*/
+	std::shared_ptr<const DistanceMatrix<int>> get_time_matrix() const;
+
+	//graph node of every customer
+	const std::vector<int>& get_graph_nodes() const;
+
+	//number of ordered pairs of customers without a road path
+	int get_unreachable() const;
+
+	std::size_t get_memory() override;
+
+	//travel time stored for the pairs without a road path, large but far from overflowing when summed by OrTools
+	static const int unreachable_time = 1 << 24;
+
+private:
+	void init(const RoadGraph& graph, int workers);
+
+	std::vector<int> graph_node;
+	int unreachable = 0;
+
+	//symmetric matrix of the mean times in the two directions
+	DistanceMatrix<double> road_matrix;
+
+	std::shared_ptr<const DistanceMatrix<int>> time_matrix;
+};
@@ -0,0 +1,409 @@
+#include "RoadGraph.h"
+#include "MappedFile.h"
+#include "ParallelFor.h"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <functional>
+#include <queue>
+#include <utility>
+
+//nodes settled by a witness search before giving up, a missing witness only adds a shortcut
+static const int witness_settled = 500;
+
+static bool is_blank(char c)
+{
+	return c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v';
+}
+
+//reads the next value of a line, returns false if it is missing or malformed
+template<class T>
+static bool read_value(const char*& it, const char* end, T& value)
+{
+	while (it != end && is_blank(*it))
+		it++;
+
+	auto result = std::from_chars(it, end, value);
+	if (result.ec != std::errc() || (result.ptr != end && !is_blank(*result.ptr)))
+		return false;
+
+	it = result.ptr;
+	return true;
+}
+
+bool RoadGraph::load(const std::string& file, parse_error& error)
+{
+	*this = RoadGraph();
+
+	auto fail = [this, &error](int line, std::string message)
+	{
+		*this = RoadGraph();
+		error.line = line;
+		error.message = std::move(message);
+		return false;
+	};
+
+	MappedFile input(file);
+	if (!input.is_open())
+		return fail(0, "can not open file or file is empty");
+
+	const char* cursor = input.data();
+	const char* end = cursor + input.size();
+
+	for (int number = 1; cursor != end; number++)
+	{
+		auto terminator = static_cast<const char*>(std::memchr(cursor, '\n', end - cursor));
+		auto line_end = (terminator == nullptr) ? end : terminator;
+		auto it = cursor;
+		cursor = (terminator == nullptr) ? end : terminator + 1;
+
+		while (it != line_end && is_blank(*it))
+			it++;
+		if (it == line_end || *it == '#')
+			continue;
+
+		auto kind = *it++;
+		if (kind == 'v')
+		{
+			double x, y;
+			if (!read_value(it, line_end, x) || !read_value(it, line_end, y))
+				return fail(number, "expected node coordinates as two numbers");
+			this->add_node(x, y);
+		}
+		else if (kind == 'a' || kind == 'e')
+		{
+			int from, to;
+			std::int64_t time;
+			if (!read_value(it, line_end, from) || !read_value(it, line_end, to) || !read_value(it, line_end, time))
+				return fail(number, "expected from, to and time as three integers");
+			if (from < 0 || to < 0 || from >= this->get_size() || to >= this->get_size())
+				return fail(number, "arc between nodes not defined before");
+			if (time < 0)
+				return fail(number, "negative travel time");
+
+			this->add_arc(from, to, time);
+			if (kind == 'e')
+				this->add_arc(to, from, time);
+		}
+		else
+			return fail(number, "unknown line, expected v, a or e");
+
+		while (it != line_end && is_blank(*it))
+			it++;
+		if (it != line_end)
+			return fail(number, "unexpected values at the end of the line");
+	}
+
+	this->contract();
+	return true;
+}
+
+int RoadGraph::add_node(double x, double y)
+{
+	this->points.push_back({ x, y, 0.0 });
+	this->out_arcs.emplace_back();
+	this->in_arcs.emplace_back();
+	return this->points.size() - 1;
+}
+
+void RoadGraph::add_arc(int from, int to, std::int64_t time)
+{
+	if (from == to)
+		return;
+
+	insert_arc(this->out_arcs[from], to, time);
+	insert_arc(this->in_arcs[to], from, time);
+}
+
+void RoadGraph::insert_arc(std::vector<arc>& arcs, int node, std::int64_t time)
+{
+	for (auto& existing : arcs)
+	{
+		if (existing.node == node)
+		{
+			existing.time = std::min(existing.time, time);
+			return;
+		}
+	}
+	arcs.push_back({ node, time });
+}
+
+int RoadGraph::contract_node(int node, const std::vector<char>& contracted, bool add, std::vector<std::int64_t>& distance, std::vector<int>& touched)
+{
+	std::int64_t max_out = 0;
+	for (auto& out : this->out_arcs[node])
+	{
+		if (!contracted[out.node])
+			max_out = std::max(max_out, out.time);
+	}
+
+	int shortcuts = 0;
+	for (std::size_t i = 0; i < this->in_arcs[node].size(); i++)
+	{
+		auto in = this->in_arcs[node][i];
+		if (contracted[in.node])
+			continue;
+
+		//witness search: paths from in.node that avoid node and are not longer than the ones through it
+		auto limit = in.time + max_out;
+		std::priority_queue<std::pair<std::int64_t, int>, std::vector<std::pair<std::int64_t, int>>, std::greater<>> queue;
+		distance[in.node] = 0;
+		touched.push_back(in.node);
+		queue.push({ 0, in.node });
+
+		for (int settled = 0; !queue.empty() && settled < witness_settled; settled++)
+		{
+			auto top = queue.top();
+			queue.pop();
+			if (top.first > limit)
+				break;
+			if (top.first > distance[top.second])
+				continue;
+
+			for (auto& out : this->out_arcs[top.second])
+			{
+				if (out.node == node || contracted[out.node])
+					continue;
+
+				auto time = top.first + out.time;
+				if (time < distance[out.node])
+				{
+					if (distance[out.node] == road_unreachable)
+						touched.push_back(out.node);
+					distance[out.node] = time;
+					queue.push({ time, out.node });
+				}
+			}
+		}
+
+		for (std::size_t j = 0; j < this->out_arcs[node].size(); j++)
+		{
+			auto out = this->out_arcs[node][j];
+			if (contracted[out.node] || out.node == in.node)
+				continue;
+
+			auto via = in.time + out.time;
+			if (distance[out.node] > via)
+			{
+				shortcuts++;
+				if (add)
+					this->add_arc(in.node, out.node, via);
+			}
+		}
+
+		for (auto touched_node : touched)
+		{
+			distance[touched_node] = road_unreachable;
+		}
+		touched.clear();
+	}
+
+	return shortcuts;
+}
+
+void RoadGraph::contract()
+{
+	int size = this->points.size();
+	std::vector<char> contracted(size, 0);
+	std::vector<int> rank(size), deleted_neighbours(size, 0);
+	std::vector<std::int64_t> distance(size, road_unreachable);
+	std::vector<int> touched;
+
+	//edge difference: shortcuts added minus arcs removed, plus the contracted neighbours to spread the order
+	auto priority = [this, &contracted, &deleted_neighbours, &distance, &touched](int node)
+	{
+		int removed = 0;
+		for (auto& out : this->out_arcs[node])
+			removed += !contracted[out.node];
+		for (auto& in : this->in_arcs[node])
+			removed += !contracted[in.node];
+
+		return this->contract_node(node, contracted, false, distance, touched) - removed + deleted_neighbours[node];
+	};
+
+	std::priority_queue<std::pair<int, int>, std::vector<std::pair<int, int>>, std::greater<>> queue;
+	for (auto i = 0; i < size; i++)
+	{
+		queue.push({ priority(i), i });
+	}
+
+	//lazy updates: a node is contracted only if its priority is still the lowest one
+	for (int order = 0; !queue.empty(); )
+	{
+		auto node = queue.top().second;
+		queue.pop();
+
+		auto current = priority(node);
+		if (!queue.empty() && current > queue.top().first)
+		{
+			queue.push({ current, node });
+			continue;
+		}
+
+		this->contract_node(node, contracted, true, distance, touched);
+		contracted[node] = 1;
+		rank[node] = order++;
+
+		for (auto& out : this->out_arcs[node])
+			deleted_neighbours[out.node]++;
+		for (auto& in : this->in_arcs[node])
+			deleted_neighbours[in.node]++;
+	}
+
+	//arcs and shortcuts split in the two upward graphs
+	this->forward_offset.assign(size + 1, 0);
+	this->backward_offset.assign(size + 1, 0);
+	for (auto from = 0; from < size; from++)
+	{
+		for (auto& out : this->out_arcs[from])
+		{
+			if (rank[out.node] > rank[from])
+				this->forward_offset[from + 1]++;
+			else
+				this->backward_offset[out.node + 1]++;
+		}
+	}
+
+	for (auto i = 0; i < size; i++)
+	{
+		this->forward_offset[i + 1] += this->forward_offset[i];
+		this->backward_offset[i + 1] += this->backward_offset[i];
+	}
+
+	this->forward.resize(this->forward_offset[size]);
+	this->backward.resize(this->backward_offset[size]);
+	std::vector<int> forward_next(this->forward_offset.begin(), this->forward_offset.end() - 1);
+	std::vector<int> backward_next(this->backward_offset.begin(), this->backward_offset.end() - 1);
+	for (auto from = 0; from < size; from++)
+	{
+		for (auto& out : this->out_arcs[from])
+		{
+			if (rank[out.node] > rank[from])
+				this->forward[forward_next[from]++] = out;
+			else
+				this->backward[backward_next[out.node]++] = { from, out.time };
+		}
+	}
+
+	//the hierarchy replaces the lists used while building
+	this->out_arcs = std::vector<std::vector<arc>>();
+	this->in_arcs = std::vector<std::vector<arc>>();
+
+	this->index = std::make_unique<SpatialIndex>(this->points);
+}
+
+bool RoadGraph::is_contracted() const
+{
+	return this->index != nullptr;
+}
+
+int RoadGraph::snap(double x, double y) const
+{
+	std::vector<int> found;
+	this->index->nearest({ x, y, 0.0 }, 1, found);
+	return found.empty() ? -1 : found[0];
+}
+
+void RoadGraph::upward_search(int source, const std::vector<int>& offset, const std::vector<arc>& arcs, std::vector<std::int64_t>& distance, std::vector<label>& settled) const
+{
+	std::priority_queue<std::pair<std::int64_t, int>, std::vector<std::pair<std::int64_t, int>>, std::greater<>> queue;
+	distance[source] = 0;
+	queue.push({ 0, source });
+
+	while (!queue.empty())
+	{
+		auto top = queue.top();
+		queue.pop();
+		if (top.first > distance[top.second])
+			continue;
+
+		settled.push_back({ top.second, top.first });
+		for (auto i = offset[top.second]; i < offset[top.second + 1]; i++)
+		{
+			auto time = top.first + arcs[i].time;
+			if (time < distance[arcs[i].node])
+			{
+				distance[arcs[i].node] = time;
+				queue.push({ time, arcs[i].node });
+			}
+		}
+	}
+
+	//every reached node has been settled
+	for (auto& reached : settled)
+	{
+		distance[reached.node] = road_unreachable;
+	}
+}
+
+std::vector<std::int64_t> RoadGraph::many_to_many(const std::vector<int>& sources, const std::vector<int>& targets, int workers) const
+{
+	if (workers <= 0)
+		workers = worker_count();
+
+	int size = this->get_size();
+	std::vector<std::vector<std::int64_t>> distances(workers, std::vector<std::int64_t>(size, road_unreachable));
+
+	//backward searches, one per target
+	std::vector<std::vector<label>> reached(targets.size());
+	parallel_for(targets.size(), [this, &targets, &distances, &reached](int task, int worker)
+	{
+		this->upward_search(targets[task], this->backward_offset, this->backward, distances[worker], reached[task]);
+	}, workers);
+
+	//buckets: (target, time) left at every node by the backward searches
+	std::vector<int> bucket_offset(size + 1, 0);
+	for (auto& labels : reached)
+	{
+		for (auto& settled : labels)
+			bucket_offset[settled.node + 1]++;
+	}
+	for (auto i = 0; i < size; i++)
+	{
+		bucket_offset[i + 1] += bucket_offset[i];
+	}
+
+	std::vector<label> bucket(bucket_offset[size]);
+	std::vector<int> next(bucket_offset.begin(), bucket_offset.end() - 1);
+	for (int target = 0; target < reached.size(); target++)
+	{
+		for (auto& settled : reached[target])
+			bucket[next[settled.node]++] = { target, settled.time };
+		reached[target] = std::vector<label>();
+	}
+
+	//forward searches, one per source, each one fills its own row
+	int columns = targets.size();
+	std::vector<std::int64_t> times(sources.size() * columns, road_unreachable);
+	parallel_for(sources.size(), [this, &sources, &distances, &bucket_offset, &bucket, &times, columns](int task, int worker)
+	{
+		std::vector<label> settled;
+		this->upward_search(sources[task], this->forward_offset, this->forward, distances[worker], settled);
+
+		auto row = times.data() + std::size_t(task) * columns;
+		for (auto& up : settled)
+		{
+			for (auto i = bucket_offset[up.node]; i < bucket_offset[up.node + 1]; i++)
+			{
+				row[bucket[i].node] = std::min(row[bucket[i].node], up.time + bucket[i].time);
+			}
+		}
+	}, workers);
+
+	return times;
+}
+
+std::int64_t RoadGraph::travel_time(int from, int to) const
+{
+	return this->many_to_many({ from }, { to }, 1)[0];
+}
+
+int RoadGraph::get_size() const
+{
+	return this->points.size();
+}
+
+std::size_t RoadGraph::get_arcs() const
+{
+	return this->forward.size() + this->backward.size();
+}
@@ -0,0 +1,124 @@
+#pragma once
+#include "InstanceParser.h"
+#include "SpatialIndex.h"
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+//travel time of the pairs without a path in a RoadGraph
+const std::int64_t road_unreachable = std::numeric_limits<std::int64_t>::max() / 4;
+
+/**
+* directed road network with travel times, answered through a contraction hierarchy
+*
+* The graph is read from a text file (see load) or built with add_node and add_arc, then contract orders the
+* nodes by importance and adds the shortcuts that keep shortest paths through the less important ones.
+* A query only goes upwards in the hierarchy, so it settles a few hundred nodes instead of the whole graph,
+* and many_to_many answers a whole table with one upward search per source and per target (bucket queries).
+*
+* After contract the graph is immutable and can be shared by many threads
+*
+*/
+class RoadGraph
+{
+public:
+	RoadGraph() = default;
+
+	/**
+	* reads a graph from a text file and contracts it. Lines starting with '#' and blank lines are skipped,
+	* the other ones are
+	*	v x y				a node, ids are given in order from 0
+	*	a from to time		a one-way arc
+	*	e from to time		a two-way road, as two arcs
+	* Coordinates are in the same system of the instances (used by snap), times are integers in the
+	* unit of the time windows (e.g. an OSM extract converted offline)
+	*
+	* input:
+	* file: file name as "name.extension"
+	* error: reference to the structure describing the first problem found
+	*
+	* output:
+	* true if the whole file has been read, otherwise the graph is left empty and error is set
+	*
+	*/
+	bool load(const std::string& file, parse_error& error);
+
+	/**
+	* adds a node, before contract
+	*
+	* output:
+	* id of the node
+	*
+	*/
+	int add_node(double x, double y);
+
+	//adds an arc between existing nodes, before contract. Parallel arcs keep the fastest one
+	void add_arc(int from, int to, std::int64_t time);
+
+	//builds the contraction hierarchy and the index used by snap, after the last node and arc
+	void contract();
+
+	bool is_contracted() const;
+
+	//node nearest to a point (Euclidean), -1 for an empty graph
+	int snap(double x, double y) const;
+
+	/**
+	* shortest travel times between every source and every target, with bucket queries:
+	* an upward search from every target leaves its distances in the buckets of the nodes it settles,
+	* then an upward search from every source reads the buckets of its nodes. Searches run in parallel
+	*
+	* input:
+	* sources, targets: node ids
+	* workers: number of threads, 0 means all the available ones
+	*
+	* output:
+	* sources.size() * targets.size() times by rows, road_unreachable for the pairs without a path
+	*
+	*/
+	std::vector<std::int64_t> many_to_many(const std::vector<int>& sources, const std::vector<int>& targets, int workers = 0) const;
+
+	//shortest travel time between two nodes, road_unreachable without a path
+	std::int64_t travel_time(int from, int to) const;
+
+	//number of nodes
+	int get_size() const;
+
+	//number of arcs of the hierarchy, shortcuts included
+	std::size_t get_arcs() const;
+
+private:
+	struct arc
+	{
+		int node;
+		std::int64_t time;
+	};
+
+	//label of a search settled at node
+	struct label
+	{
+		int node;
+		std::int64_t time;
+	};
+
+	//arcs of the graph while it is built, by node. Also used while contracting
+	std::vector<std::vector<arc>> out_arcs, in_arcs;
+	std::vector<index_point> points;
+
+	//upward graphs in compressed sparse row format: forward arcs go to more important nodes,
+	//backward arcs come from more important nodes and are stored at their head
+	std::vector<int> forward_offset, backward_offset;
+	std::vector<arc> forward, backward;
+
+	std::unique_ptr<SpatialIndex> index;
+
+	static void insert_arc(std::vector<arc>& arcs, int node, std::int64_t time);
+
+	//shortcuts needed to contract node, added to the graph only if add is true
+	int contract_node(int node, const std::vector<char>& contracted, bool add, std::vector<std::int64_t>& distance, std::vector<int>& touched);
+
+	//nodes settled by an upward search with their times. distance must be all road_unreachable, so it is left
+	void upward_search(int source, const std::vector<int>& offset, const std::vector<arc>& arcs, std::vector<std::int64_t>& distance, std::vector<label>& settled) const;
+};
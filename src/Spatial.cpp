@@ -1,39 +1,100 @@
 #include "Spatial.h"
+#include "NodesSnapshot.h"
+#include "Instance.h"
+#include "DistanceKernels.h"
 #include <iostream>
 #include <array>
 
 
-Spatial::Spatial(std::string file) : NodesDistance::NodesDistance(file)
+Spatial::Spatial(std::string file, matrix_layout layout, matrix_precision precision) : NodesDistance::NodesDistance(file)
 {
-	this->init();
+	this->init(layout, precision);
 }
 
-Spatial::Spatial(nodes &node) : NodesDistance::NodesDistance(node)
+Spatial::Spatial(nodes &node, matrix_layout layout, matrix_precision precision) : NodesDistance::NodesDistance(node)
 {
-	this->init();
+	this->init(layout, precision);
 }
 
-void Spatial::init()
+Spatial::Spatial(NodesSnapshot& snapshot) : NodesDistance::NodesDistance(snapshot)
 {
-	this->spatial_matrix.resize(this->size);
+	//borrow the stored matrix instead of computing the distances again
+	this->spatial_matrix = snapshot.matrix(snapshot_matrix::spatial);
 
-	//initialize each entry of the matrix with the Euclidian distance between pairs of customers
+	if (this->spatial_matrix.get_size() != this->size)
+		this->init(matrix_layout::full, matrix_precision::f64);
+}
+
+Spatial::Spatial(std::shared_ptr<const Instance> instance, matrix_precision precision) : NodesDistance::NodesDistance(instance)
+{
+	auto& matrix = instance->get_spatial_matrix();
+
+	if (precision != matrix_precision::f64)
+	{
+		this->init(matrix.get_layout(), precision);
+		return;
+	}
+
+	//the borrowed matrix keeps the instance alive
+	this->spatial_matrix = DistanceMatrix<double>(matrix.data(), matrix.get_size(), matrix.get_layout(), instance);
+}
+
+void Spatial::init(matrix_layout layout, matrix_precision precision)
+{
+	//coordinates as structure of arrays, used by the batch kernels
+	std::vector<double> x(this->size), y(this->size);
 	for (auto i = 0; i < this->size; i++)
 	{
-		this->spatial_matrix[i].resize(size);
-		for (auto j = 0; j < size; j++)
+		x[i] = this->node->coord[i][0];
+		y[i] = this->node->coord[i][1];
+	}
+
+	//reduced precisions round the distances computed a row at a time
+	if (precision != matrix_precision::f64)
+	{
+		this->spatial_matrix.compute_symmetric(this->size, layout, precision, [this, &x, &y](int i, double* values)
 		{
-			this->spatial_matrix[i][j] = euclidean_distance(i, j);
-		}
+			euclidean_row(x.data(), y.data(), i, i, this->size, values, nullptr);
+		});
+		return;
+	}
+
+	this->spatial_matrix.resize(this->size, layout, precision);
+	auto& matrix = this->spatial_matrix.get_double();
+
+	//initialize each entry of the matrix with the Euclidian distance between pairs of customers, one row at a time.
+	//The distance is symmetric, a packed matrix stores only the upper part of each row
+	for (auto i = 0; i < this->size; i++)
+	{
+		if (layout == matrix_layout::full)
+			euclidean_row(x.data(), y.data(), i, 0, this->size, matrix.row(i), nullptr);
+		else
+			euclidean_row(x.data(), y.data(), i, i, this->size, matrix.upper_row(i), nullptr);
 	}
 }
 
 double Spatial::euclidean_distance(int from_id, int to_id)
 {
-	return std::sqrt(std::pow((this->node.coord[from_id][0] - this->node.coord[to_id][0]), 2) + std::pow((this->node.coord[from_id][1] - this->node.coord[to_id][1]), 2));
+	return std::sqrt(std::pow((this->node->coord[from_id][0] - this->node->coord[to_id][0]), 2) + std::pow((this->node->coord[from_id][1] - this->node->coord[to_id][1]), 2));
 }
 
 double Spatial::get_distance(int from_id, int to_id)
 {
-	return this->spatial_matrix[from_id][to_id];
+	return this->distance(from_id, to_id);
+}
+
+const PrecisionMatrix& Spatial::get_spatial_matrix() const
+{
+	return this->spatial_matrix;
+}
+
+void Spatial::add_to_snapshot(snapshot_matrices& matrices)
+{
+	if (this->spatial_matrix.get_precision() == matrix_precision::f64)
+		matrices.spatial = &this->spatial_matrix.get_double();
+}
+
+std::size_t Spatial::get_memory()
+{
+	return this->spatial_matrix.bytes();
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 #include "NodesDistance.h"
+#include "PrecisionMatrix.h"
 
 /**
 * NodesDistance's derived class
@@ -13,18 +14,42 @@ public:
 	* constructor from file
 	* input
 	* file: file name as "name.extension"
+	* layout: storage of the distance matrix, packed needs half of the memory
+	* precision: type of the stored distances, f32 and u16 need less memory but round the distances
 	* 
 	*/
-	Spatial(std::string file);
+	Spatial(std::string file, matrix_layout layout = matrix_layout::full, matrix_precision precision = matrix_precision::f64);
 
 	/**
 	* constructor from struct nodes
 	*
 	* input
 	* node: reference to an existing struct nodes
+	* layout: storage of the distance matrix, packed needs half of the memory
+	* precision: type of the stored distances, f32 and u16 need less memory but round the distances
 	*
 	*/
-	Spatial(nodes &node);
+	Spatial(nodes &node, matrix_layout layout = matrix_layout::full, matrix_precision precision = matrix_precision::f64);
+
+	/**
+	* constructor from snapshot, the stored spatial matrix is used without copies if available
+	*
+	* input
+	* snapshot: reference to an opened NodesSnapshot
+	*
+	*/
+	Spatial(NodesSnapshot& snapshot);
+
+	/**
+	* constructor from a shared instance. With f64 the spatial matrix of the instance is borrowed,
+	* reduced precisions compute their own matrix with the layout of the instance
+	*
+	* input
+	* instance: instance shared with other objects
+	* precision: type of the stored distances
+	*
+	*/
+	Spatial(std::shared_ptr<const Instance> instance, matrix_precision precision = matrix_precision::f64);
 
 	/**
 	* implements NodesDistance's virtual function
@@ -39,12 +64,28 @@ public:
 	*/
 	double get_distance(int from_id, int to_id) override;
 
+	//same of get_distance but not virtual, it can be inlined when the type is known at compile time (see DistancePolicy.h)
+	double distance(int from_id, int to_id) const
+	{
+		return this->spatial_matrix.get(from_id, to_id);
+	}
+
+	//stored distances, read by the distance policies with their precision known at compile time (see visit_distance)
+	const PrecisionMatrix& get_spatial_matrix() const;
+
+	//adds the spatial matrix, only if stored as double
+	void add_to_snapshot(snapshot_matrices& matrices) override;
+
+	std::size_t get_memory() override;
+
 protected:
 
 	//square matrix containing the distances between all pairs of customers
-	std::vector<std::vector<double>> spatial_matrix;
+	PrecisionMatrix spatial_matrix;
 
-private:
+	//Euclidean distance computed from the coordinates, equal to the stored one when the precision is f64
 	double euclidean_distance(int from_id, int to_id);
-	void init();
+
+private:
+	void init(matrix_layout layout, matrix_precision precision);
 };
\ No newline at end of file
@@ -1,31 +1,71 @@
 #include "Spatial3d.h"
+#include "DistanceKernels.h"
 #include <iostream>
 #include <array>
 
-Spatial3d::Spatial3d(nodes& node) : NodesDistance::NodesDistance(node)
+Spatial3d::Spatial3d(nodes& node, matrix_layout layout, matrix_precision precision) : NodesDistance::NodesDistance(node)
 {
-	this->spatial3d_matrix.resize(this->size);
+	this->init(layout, precision);
+}
 
+Spatial3d::Spatial3d(std::shared_ptr<const Instance> instance, matrix_layout layout, matrix_precision precision) : NodesDistance::NodesDistance(instance)
+{
+	this->init(layout, precision);
+}
+
+void Spatial3d::init(matrix_layout layout, matrix_precision precision)
+{
+	//coordinates as structure of arrays, the third axis is the same used by euclidean3d_distance
+	std::vector<double> x(this->size), y(this->size), z(this->size);
 	for (auto i = 0; i < this->size; i++)
 	{
-		this->spatial3d_matrix[i].resize(this->size);
-		for (auto j = 0; j < this->size; j++)
+		x[i] = this->node->coord[i][0];
+		y[i] = this->node->coord[i][1];
+		z[i] = this->node->time_window[i][0] + this->node->time_window[i][1] / 2.0;
+	}
+
+	if (precision != matrix_precision::f64)
+	{
+		this->spatial3d_matrix.compute_symmetric(this->size, layout, precision, [this, &x, &y, &z](int i, double* values)
 		{
-			this->spatial3d_matrix[i][j] = this->euclidean3d_distance(i, j);
-		}
+			euclidean3d_row(x.data(), y.data(), z.data(), i, i, this->size, values);
+		});
+		return;
+	}
+
+	this->spatial3d_matrix.resize(this->size, layout, precision);
+	auto& matrix = this->spatial3d_matrix.get_double();
+
+	//one row at a time, a packed matrix stores only the upper part of each row
+	for (auto i = 0; i < this->size; i++)
+	{
+		if (layout == matrix_layout::full)
+			euclidean3d_row(x.data(), y.data(), z.data(), i, 0, this->size, matrix.row(i));
+		else
+			euclidean3d_row(x.data(), y.data(), z.data(), i, i, this->size, matrix.upper_row(i));
 	}
 }
 
 double Spatial3d::euclidean3d_distance(int from_id, int to_id)
 {
-	auto temp = std::pow(this->node.coord[from_id][0] - this->node.coord[to_id][0] , 2);
-	temp += std::pow(this->node.coord[from_id][1] - this->node.coord[to_id][1], 2);
-	temp += std::pow((this->node.time_window[from_id][0] + this->node.time_window[from_id][1] / 2.0) -
-		(this->node.time_window[to_id][0] + this->node.time_window[to_id][1] / 2.0), 2);
+	auto temp = std::pow(this->node->coord[from_id][0] - this->node->coord[to_id][0] , 2);
+	temp += std::pow(this->node->coord[from_id][1] - this->node->coord[to_id][1], 2);
+	temp += std::pow((this->node->time_window[from_id][0] + this->node->time_window[from_id][1] / 2.0) -
+		(this->node->time_window[to_id][0] + this->node->time_window[to_id][1] / 2.0), 2);
 	return std::sqrt(temp);
 }
 
 double Spatial3d::get_distance(int from_id, int to_id)
 {
-	return this->spatial3d_matrix[from_id][to_id];
+	return this->distance(from_id, to_id);
+}
+
+const PrecisionMatrix& Spatial3d::get_spatial3d_matrix() const
+{
+	return this->spatial3d_matrix;
+}
+
+std::size_t Spatial3d::get_memory()
+{
+	return this->spatial3d_matrix.bytes();
 }
\ No newline at end of file
@@ -1,13 +1,14 @@
 #pragma once
 #pragma once
 #include "NodesDistance.h"
+#include "PrecisionMatrix.h"
 
 /**
 * NodesDistance's derived class
 * distance is implemented as Euclidean distance
 *
 */
-class Spatial3d : public NodesDistance
+class Spatial3d final : public NodesDistance
 {
 public:
 	
@@ -16,9 +17,21 @@ public:
 	*
 	* input
 	* node: reference to an existing struct nodes
+	* layout: storage of the distance matrix, packed needs half of the memory
+	* precision: type of the stored distances, f32 and u16 need less memory but round the distances
 	*
 	*/
-	Spatial3d(nodes& node);
+	Spatial3d(nodes& node, matrix_layout layout = matrix_layout::full, matrix_precision precision = matrix_precision::f64);
+
+	/**
+	* constructor from a shared instance, its nodes are borrowed
+	*
+	* input
+	* instance: instance shared with other objects
+	* layout, precision: same as above
+	*
+	*/
+	Spatial3d(std::shared_ptr<const Instance> instance, matrix_layout layout = matrix_layout::full, matrix_precision precision = matrix_precision::f64);
 
 	/**
 	* implements NodesDistance's virtual function
@@ -33,11 +46,24 @@ public:
 	*/
 	double get_distance(int from_id, int to_id) override;
 
+	//non virtual version of get_distance (see Spatial::distance)
+	double distance(int from_id, int to_id) const
+	{
+		return this->spatial3d_matrix.get(from_id, to_id);
+	}
+
+	//stored 3d distances (see Spatial::get_spatial_matrix)
+	const PrecisionMatrix& get_spatial3d_matrix() const;
+
+	std::size_t get_memory() override;
+
 protected:
 
 	//square matrix containing the distances between all pairs of customers
-	std::vector<std::vector<double>> spatial3d_matrix;
+	PrecisionMatrix spatial3d_matrix;
 
 private:
 	double euclidean3d_distance(int from_id, int to_id);
+
+	void init(matrix_layout layout, matrix_precision precision);
 };
\ No newline at end of file
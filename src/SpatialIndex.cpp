@@ -0,0 +1,293 @@
+#include "SpatialIndex.h"
+#include "ParallelFor.h"
+#include <algorithm>
+#include <cmath>
+
+SpatialIndex::SpatialIndex(const nodes& node, index_axes axes)
+{
+	this->dimensions = axes == index_axes::temporal ? 3 : 2;
+
+	int size = node.id.size();
+	this->points.resize(size);
+	for (auto i = 0; i < size; i++)
+	{
+		//third axis as Spatial3d
+		auto time = axes == index_axes::temporal ? node.time_window[i][0] + node.time_window[i][1] / 2.0 : 0.0;
+		this->points[i] = { double(node.coord[i][0]), double(node.coord[i][1]), time };
+	}
+
+	//depot excluded
+	this->init(1);
+}
+
+SpatialIndex::SpatialIndex(const std::vector<index_point>& points, index_axes axes)
+{
+	this->dimensions = axes == index_axes::temporal ? 3 : 2;
+	this->points = points;
+	this->init(0);
+}
+
+void SpatialIndex::init(int first)
+{
+	for (int i = first; i < this->points.size(); i++)
+	{
+		this->entries.push_back({ this->points[i], i });
+	}
+	this->split.resize(this->entries.size());
+
+	this->build(0, this->entries.size());
+}
+
+void SpatialIndex::build(int begin, int end)
+{
+	if (end - begin <= leaf_size)
+		return;
+
+	//split on the axis with the largest spread
+	index_point low = this->entries[begin].point, high = low;
+	for (auto i = begin + 1; i < end; i++)
+	{
+		for (auto axis = 0; axis < this->dimensions; axis++)
+		{
+			low[axis] = std::min(low[axis], this->entries[i].point[axis]);
+			high[axis] = std::max(high[axis], this->entries[i].point[axis]);
+		}
+	}
+
+	int axis = 0;
+	for (auto i = 1; i < this->dimensions; i++)
+	{
+		if (high[i] - low[i] > high[axis] - low[axis])
+			axis = i;
+	}
+
+	//nth_element is linear, the whole tree is O(n log n)
+	auto mid = (begin + end) / 2;
+	std::nth_element(this->entries.begin() + begin, this->entries.begin() + mid, this->entries.begin() + end, [axis](const entry& a, const entry& b)
+	{
+		return a.point[axis] < b.point[axis];
+	});
+	this->split[mid] = axis;
+
+	this->build(begin, mid);
+	this->build(mid + 1, end);
+}
+
+double SpatialIndex::squared_distance(const index_point& from, const index_point& to) const
+{
+	double total = 0;
+	for (auto axis = 0; axis < this->dimensions; axis++)
+	{
+		auto difference = from[axis] - to[axis];
+		total += difference * difference;
+	}
+	return total;
+}
+
+void SpatialIndex::nearest(const index_point& target, int k, std::vector<int>& found, std::vector<double>* distance, int exclude) const
+{
+	std::vector<std::pair<double, int>> heap;
+	if (k > 0)
+	{
+		heap.reserve(k);
+		this->search_nearest(0, this->entries.size(), target, k, exclude, heap);
+	}
+
+	std::sort_heap(heap.begin(), heap.end());
+
+	found.resize(heap.size());
+	for (auto i = 0; i < heap.size(); i++)
+	{
+		found[i] = heap[i].second;
+	}
+
+	if (distance)
+	{
+		distance->resize(heap.size());
+		for (auto i = 0; i < heap.size(); i++)
+		{
+			(*distance)[i] = std::sqrt(heap[i].first);
+		}
+	}
+}
+
+void SpatialIndex::search_nearest(int begin, int end, const index_point& target, int k, int exclude, std::vector<std::pair<double, int>>& heap) const
+{
+	auto offer = [&heap, k, exclude](double distance, int id)
+	{
+		if (id == exclude)
+			return;
+
+		std::pair<double, int> candidate(distance, id);
+		if (heap.size() < k)
+		{
+			heap.push_back(candidate);
+			std::push_heap(heap.begin(), heap.end());
+		}
+		else if (candidate < heap.front())
+		{
+			std::pop_heap(heap.begin(), heap.end());
+			heap.back() = candidate;
+			std::push_heap(heap.begin(), heap.end());
+		}
+	};
+
+	if (end - begin <= leaf_size)
+	{
+		for (auto i = begin; i < end; i++)
+		{
+			offer(this->squared_distance(target, this->entries[i].point), this->entries[i].id);
+		}
+		return;
+	}
+
+	auto mid = (begin + end) / 2;
+	auto& median = this->entries[mid];
+	offer(this->squared_distance(target, median.point), median.id);
+
+	//nearer side first, the other one only if it can hold a customer as near as the worst found
+	auto difference = target[this->split[mid]] - median.point[this->split[mid]];
+	if (difference < 0)
+		this->search_nearest(begin, mid, target, k, exclude, heap);
+	else
+		this->search_nearest(mid + 1, end, target, k, exclude, heap);
+
+	if (heap.size() < k || difference * difference <= heap.front().first)
+	{
+		if (difference < 0)
+			this->search_nearest(mid + 1, end, target, k, exclude, heap);
+		else
+			this->search_nearest(begin, mid, target, k, exclude, heap);
+	}
+}
+
+void SpatialIndex::radius(const index_point& target, double radius, std::vector<int>& found) const
+{
+	found.clear();
+	if (radius >= 0)
+		this->search_radius(0, this->entries.size(), target, radius * radius, found);
+	std::sort(found.begin(), found.end());
+}
+
+void SpatialIndex::search_radius(int begin, int end, const index_point& target, double squared_radius, std::vector<int>& found) const
+{
+	if (end - begin <= leaf_size)
+	{
+		for (auto i = begin; i < end; i++)
+		{
+			if (this->squared_distance(target, this->entries[i].point) <= squared_radius)
+				found.push_back(this->entries[i].id);
+		}
+		return;
+	}
+
+	auto mid = (begin + end) / 2;
+	auto& median = this->entries[mid];
+	if (this->squared_distance(target, median.point) <= squared_radius)
+		found.push_back(median.id);
+
+	auto difference = target[this->split[mid]] - median.point[this->split[mid]];
+	if (difference <= 0 || difference * difference <= squared_radius)
+		this->search_radius(begin, mid, target, squared_radius, found);
+	if (difference >= 0 || difference * difference <= squared_radius)
+		this->search_radius(mid + 1, end, target, squared_radius, found);
+}
+
+void SpatialIndex::box(const index_point& low, const index_point& high, std::vector<int>& found) const
+{
+	found.clear();
+	this->search_box(0, this->entries.size(), low, high, found);
+	std::sort(found.begin(), found.end());
+}
+
+void SpatialIndex::search_box(int begin, int end, const index_point& low, const index_point& high, std::vector<int>& found) const
+{
+	auto inside = [this, &low, &high](const index_point& point)
+	{
+		for (auto axis = 0; axis < this->dimensions; axis++)
+		{
+			if (point[axis] < low[axis] || point[axis] > high[axis])
+				return false;
+		}
+		return true;
+	};
+
+	if (end - begin <= leaf_size)
+	{
+		for (auto i = begin; i < end; i++)
+		{
+			if (inside(this->entries[i].point))
+				found.push_back(this->entries[i].id);
+		}
+		return;
+	}
+
+	auto mid = (begin + end) / 2;
+	auto& median = this->entries[mid];
+	if (inside(median.point))
+		found.push_back(median.id);
+
+	auto axis = this->split[mid];
+	if (low[axis] <= median.point[axis])
+		this->search_box(begin, mid, low, high, found);
+	if (high[axis] >= median.point[axis])
+		this->search_box(mid + 1, end, low, high, found);
+}
+
+std::vector<std::vector<int>> SpatialIndex::nearest(const std::vector<index_point>& targets, int k, int workers) const
+{
+	std::vector<std::vector<int>> found(targets.size());
+	parallel_for(targets.size(), [this, &targets, &found, k](int task, int worker)
+	{
+		this->nearest(targets[task], k, found[task]);
+	}, workers);
+	return found;
+}
+
+std::vector<std::vector<int>> SpatialIndex::radius(const std::vector<index_point>& targets, double radius, int workers) const
+{
+	std::vector<std::vector<int>> found(targets.size());
+	parallel_for(targets.size(), [this, &targets, &found, radius](int task, int worker)
+	{
+		this->radius(targets[task], radius, found[task]);
+	}, workers);
+	return found;
+}
+
+neighbour_lists SpatialIndex::nearest_customers(int k, int workers) const
+{
+	int size = this->points.size();
+	neighbour_lists lists;
+
+	//same number of neighbours for every row, as NodesDistance::build_neighbours
+	k = std::max(0, std::min(k, size - 2));
+	lists.offset.resize(size + 1);
+	for (auto i = 0; i <= size; i++)
+	{
+		lists.offset[i] = i * k;
+	}
+	lists.id.resize(size * k);
+	lists.distance.resize(size * k);
+
+	parallel_for(size, [this, k, &lists](int i, int worker)
+	{
+		std::vector<int> found;
+		std::vector<double> distance;
+		this->nearest(this->points[i], k, found, &distance, i);
+
+		std::copy(found.begin(), found.end(), lists.id.begin() + lists.offset[i]);
+		std::copy(distance.begin(), distance.end(), lists.distance.begin() + lists.offset[i]);
+	}, workers);
+
+	return lists;
+}
+
+index_point SpatialIndex::get_point(int customer) const
+{
+	return this->points[customer];
+}
+
+int SpatialIndex::get_size() const
+{
+	return this->entries.size();
+}
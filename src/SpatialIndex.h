@@ -0,0 +1,149 @@
+#pragma once
+#include "NodesDistance.h"
+#include <array>
+#include <utility>
+#include <vector>
+
+//axes of the points stored by a SpatialIndex
+enum class index_axes
+{
+	//x and y coordinates
+	planar,
+
+	//x, y and the time window value used by Spatial3d as third coordinate
+	temporal
+};
+
+//point of a SpatialIndex query, the third coordinate is ignored by planar indexes
+using index_point = std::array<double, 3>;
+
+/**
+* kd-tree over the customers of an instance, the depot is not indexed, or over any set of points
+*
+* Answers "which customers lie near a point" without scanning all of them and without distance matrices:
+* nearest, radius and box queries visit only the cells that can contain a result. The tree is built once
+* in O(n log n) and never modified, so queries can be made by many threads at the same time
+* (the batched versions use parallel_for).
+* Distances are Euclidean over the axes of the index, as Spatial (planar) and Spatial3d (temporal).
+*
+*/
+class SpatialIndex
+{
+public:
+	/**
+	* constructor
+	*
+	* input
+	* node: reference to an existing struct nodes, it is not needed after the construction
+	* axes: planar or temporal points
+	*
+	*/
+	SpatialIndex(const nodes& node, index_axes axes = index_axes::planar);
+
+	/**
+	* constructor from points that are not customers (e.g. the nodes of a RoadGraph), all of them are indexed
+	* and their ids are their positions
+	*
+	* input
+	* points: points to index
+	* axes: planar or temporal points
+	*
+	*/
+	SpatialIndex(const std::vector<index_point>& points, index_axes axes = index_axes::planar);
+
+	/**
+	* k nearest customers of a point
+	*
+	* input:
+	* target: query point
+	* k: maximum number of customers
+	* found: receives the customer ids, nearest first (lower id first in case of ties)
+	* distance: if not null receives the distances in the same order of found
+	* exclude: customer id left out of the result (e.g. the customer of target), -1 for none
+	*
+	*/
+	void nearest(const index_point& target, int k, std::vector<int>& found, std::vector<double>* distance = nullptr, int exclude = -1) const;
+
+	/**
+	* customers within a distance from a point
+	*
+	* input:
+	* target: query point
+	* radius: maximum distance, included
+	* found: receives the customer ids in increasing order
+	*
+	*/
+	void radius(const index_point& target, double radius, std::vector<int>& found) const;
+
+	/**
+	* customers inside an axis aligned box
+	*
+	* input:
+	* low, high: opposite corners of the box, included
+	* found: receives the customer ids in increasing order
+	*
+	*/
+	void box(const index_point& low, const index_point& high, std::vector<int>& found) const;
+
+	/**
+	* batched nearest and radius queries, one query per task of parallel_for
+	*
+	* input:
+	* targets: query points
+	* k, radius: same as above
+	* workers: number of threads, 0 means all the available ones
+	*
+	* output:
+	* result of every query in the same order of targets
+	*
+	*/
+	std::vector<std::vector<int>> nearest(const std::vector<index_point>& targets, int k, int workers = 0) const;
+	std::vector<std::vector<int>> radius(const std::vector<index_point>& targets, double radius, int workers = 0) const;
+
+	/**
+	* k nearest customers of every customer and of the depot, the same lists of NodesDistance::build_neighbours
+	* with the distance of the index but without computing all the pairs
+	*
+	* input:
+	* k: maximum number of neighbours
+	* workers: number of threads, 0 means all the available ones
+	*
+	*/
+	neighbour_lists nearest_customers(int k, int workers = 0) const;
+
+	//point of a customer or of the depot
+	index_point get_point(int customer) const;
+
+	//number of indexed customers
+	int get_size() const;
+
+private:
+	struct entry
+	{
+		index_point point;
+		int id;
+	};
+
+	//ranges with at most leaf_size entries are not split and are scanned
+	static const int leaf_size = 8;
+
+	//indexes the points from first on
+	void init(int first);
+	void build(int begin, int end);
+
+	double squared_distance(const index_point& from, const index_point& to) const;
+
+	//(squared distance, id) of the best customers, as a max heap
+	void search_nearest(int begin, int end, const index_point& target, int k, int exclude, std::vector<std::pair<double, int>>& heap) const;
+	void search_radius(int begin, int end, const index_point& target, double squared_radius, std::vector<int>& found) const;
+	void search_box(int begin, int end, const index_point& low, const index_point& high, std::vector<int>& found) const;
+
+	int dimensions = 2;
+
+	//customers in tree order: the median of every range splits it on the axis stored in split
+	std::vector<entry> entries;
+	std::vector<unsigned char> split;
+
+	//indexed points and the ones left out, by id
+	std::vector<index_point> points;
+};
@@ -1,36 +1,59 @@
 #include "SpatioTemporal.h"
+#include "NodesSnapshot.h"
+#include "ParallelFor.h"
+#include "DistanceKernels.h"
 #include <array>
 #include <iostream>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <limits>
 
-SpatioTemporal::SpatioTemporal(std::string file) : Spatial(file)
+SpatioTemporal::SpatioTemporal(std::string file, matrix_layout layout, matrix_precision precision) : Spatial(file, layout, precision)
 {
 	this->init();
 }
 
-SpatioTemporal::SpatioTemporal(nodes &node) : Spatial(node) 
+SpatioTemporal::SpatioTemporal(nodes &node, matrix_layout layout, matrix_precision precision) : Spatial(node, layout, precision)
 {
 	this->init();
 }
 
-SpatioTemporal::SpatioTemporal(std::string file, double k1, double k2, double k3, double alpha1) : Spatial(file)
+SpatioTemporal::SpatioTemporal(std::string file, double k1, double k2, double k3, double alpha1, matrix_layout layout, matrix_precision precision) : Spatial(file, layout, precision)
 {
-	if (k1 < k2 && k2 < k3)
-	{
-		this->k1 = k1;
-		this->k2 = k2;
-		this->k3 = k3;
-	}
+	this->set_parameters(k1, k2, k3, alpha1);
+	this->init();
+}
 
-	if (alpha1 >= 0.0 && alpha1 <= 1.0)
-	{
-		this->alpha1 = alpha1;
-		this->alpha2 = 1.0 - alpha1;
-	}
+SpatioTemporal::SpatioTemporal(nodes &node, double k1, double k2, double k3, double alpha1, matrix_layout layout, matrix_precision precision) : Spatial(node, layout, precision)
+{
+	this->set_parameters(k1, k2, k3, alpha1);
+	this->init();
+}
 
+SpatioTemporal::SpatioTemporal(std::shared_ptr<const Instance> instance, matrix_precision precision) : Spatial(instance, precision)
+{
 	this->init();
 }
 
-SpatioTemporal::SpatioTemporal(nodes &node, double k1, double k2, double k3, double alpha1) : Spatial(node)
+SpatioTemporal::SpatioTemporal(std::shared_ptr<const Instance> instance, double k1, double k2, double k3, double alpha1, matrix_precision precision) : Spatial(instance, precision)
+{
+	this->set_parameters(k1, k2, k3, alpha1);
+	this->init();
+}
+
+SpatioTemporal::SpatioTemporal(NodesSnapshot& snapshot) : Spatial(snapshot)
+{
+	this->init(snapshot);
+}
+
+SpatioTemporal::SpatioTemporal(NodesSnapshot& snapshot, double k1, double k2, double k3, double alpha1) : Spatial(snapshot)
+{
+	this->set_parameters(k1, k2, k3, alpha1);
+	this->init(snapshot);
+}
+
+void SpatioTemporal::set_parameters(double k1, double k2, double k3, double alpha1)
 {
 	if (k1 < k2 && k2 < k3)
 	{
@@ -44,33 +67,77 @@ SpatioTemporal::SpatioTemporal(nodes &node, double k1, double k2, double k3, dou
 		this->alpha1 = alpha1;
 		this->alpha2 = 1.0 - alpha1;
 	}
+}
 
-	this->init();
+void SpatioTemporal::init(NodesSnapshot& snapshot)
+{
+	//stored matrices are valid only if computed with the same parameters
+	if (!snapshot.same_parameters(this->k1, this->k2, this->k3, this->alpha1))
+	{
+		this->init();
+		return;
+	}
+
+	//borrow the stored matrices instead of computing them again
+	this->temporal_matrix = snapshot.matrix(snapshot_matrix::temporal);
+	this->spatio_temporal_matrix = snapshot.matrix(snapshot_matrix::spatio_temporal);
+
+	//scaling bounds are not stored, they are needed by the views over other alphas (see AlphaView).
+	//Single temporal distances, as the first candidate of the bounds, also need the max time window width
+	this->find_max_width();
+	this->find_bounds();
 }
 
-void SpatioTemporal::init()
+void SpatioTemporal::find_bounds()
 {
-	//find max, min euclidian distance and max time window width exluding the depot
-	for (auto i = 0; i < this->size; i++)
+	this->min_distance = this->max_distance = this->min_time = this->max_time = 0.0;
+	if (this->size <= 2)
+		return;
+
+	//same candidates of init(): all pairs of different customers, depot excluded. The first pair is also computed as in init(),
+	//its temporal distance in a single direction, so stored and freshly computed matrices are scaled with the same bounds
+	this->min_distance = this->max_distance = this->euclidean_distance(1, 2);
+	this->min_time = this->max_time = this->temporal_distance(1, 2);
+
+	for (auto i = 1; i < this->size; i++)
 	{
-		for (auto j = 0; j < this->size; j++)
+		for (auto j = i + 1; j < this->size; j++)
 		{
-			//excluding depot from best min and max spatial distance candidate
-			if (i == 1 && j == 2)
-			{
-				this->max_distance = this->spatial_matrix[i][j];
-				this->min_distance = this->max_distance;
-			}
-			else if (i != j && i != 0 && j != 0)
-			{
-				if (this->spatial_matrix[i][j] > this->max_distance)
-					this->max_distance = this->spatial_matrix[i][j];
-				if (this->spatial_matrix[i][j] < this->min_distance)
-					this->min_distance = this->spatial_matrix[i][j];
-			}
+			auto spatial = this->spatial_matrix.get(i, j);
+			auto temporal = this->temporal_matrix.get(i, j);
+
+			this->min_distance = std::min(this->min_distance, spatial);
+			this->max_distance = std::max(this->max_distance, spatial);
+			this->min_time = std::min(this->min_time, temporal);
+			this->max_time = std::max(this->max_time, temporal);
 		}
+	}
+}
 
-		auto temp_width = this->node.time_window[i][1] - this->node.time_window[i][0];
+//side of the square tiles of the matrices computed by a single thread
+static const int tile_size = 64;
+
+//min and max candidates found by a single thread, on its own cache line
+struct alignas(64) bounds
+{
+	//depot excluded, used for scaling
+	double min_distance;
+	double max_distance;
+	double min_time;
+	double max_time;
+
+	//depot included, range of the values stored with reduced precision
+	double min_all_distance;
+	double max_all_distance;
+	double min_all_time;
+	double max_all_time;
+};
+
+void SpatioTemporal::find_max_width()
+{
+	for (auto i = 0; i < this->size; i++)
+	{
+		auto temp_width = this->node->time_window[i][1] - this->node->time_window[i][0];
 
 		if (i == 0)
 		{
@@ -81,93 +148,226 @@ void SpatioTemporal::init()
 		{
 			this->max_width = temp_width;
 		}
-
 	}
+}
 
-	this->temporal_matrix.resize(this->size);
-
-	//initial min and max temporal distance
-	auto temp_min = this->temporal_distance(1, 2);
-	auto temp_max = temp_min;
-
-	for (auto i = 0; i < size; i++)
+void SpatioTemporal::init()
+{
+	this->find_max_width();
+
+	//temporal and spatiotemporal matrices use the same layout and precision of the spatial one
+	auto layout = this->spatial_matrix.get_layout();
+	auto precision = this->spatial_matrix.get_precision();
+
+	/*
+	* with double precision the temporal matrix is stored by the first pass and read back by the second one.
+	* Reduced precisions need the range of the values before storing them: the first pass only finds min and max,
+	* the second one computes spatial and temporal distances again, so that every stored value comes from exact distances
+	*/
+	bool exact = precision == matrix_precision::f64;
+	if (exact)
+		this->temporal_matrix.resize(this->size, layout, precision);
+
+	//initial min and max spatial and temporal distance, the first pair of customers excluding the depot
+	auto infinity = std::numeric_limits<double>::infinity();
+	bounds initial = { 0.0, 0.0, 0.0, 0.0, infinity, -infinity, infinity, -infinity };
+	if (this->size > 2)
 	{
+		initial.min_distance = initial.max_distance = this->euclidean_distance(1, 2);
+		initial.min_time = initial.max_time = this->temporal_distance(1, 2);
+	}
 
-		for (auto j = i; j < size; j++)
+	/*
+	* the upper triangle is split in square tiles, a task is a row of tiles. Every pair (i, j) with i <= j belongs to
+	* a single tile, so threads write disjoint entries, and min and max do not depend on the order the pairs are visited:
+	* results are the same of a single thread
+	*/
+	auto tile_rows = (this->size + tile_size - 1) / tile_size;
+	//segment(i, begin, end, worker) is called for the part [begin; end) of row i inside a tile
+	auto for_each_tile = [this, tile_rows](auto segment)
+	{
+		return [this, tile_rows, segment](int task, int worker)
 		{
-			if (i == 0)
-				this->temporal_matrix[j].resize(this->size);
+			auto first_row = task * tile_size;
+			auto last_row = std::min(first_row + tile_size, this->size);
 
-			if (i != j)
+			for (auto tile = task; tile < tile_rows; tile++)
 			{
-				//the distance is not unidirectional and the paper indicates the max as the right candidate, but results corrispond taking the min.
-				this->temporal_matrix[i][j] = std::min(this->temporal_distance(i, j), this->temporal_distance(j, i));				
-				this->temporal_matrix[j][i] = this->temporal_matrix[i][j];
+				auto first_column = tile * tile_size;
+				auto last_column = std::min(first_column + tile_size, this->size);
 
-				//excluding depot from best min and max temporal distance candidate
-				if (temporal_matrix[i][j] < temp_min && i != 0 && j != 0)
+				for (auto i = first_row; i < last_row; i++)
 				{
-					temp_min = temporal_matrix[i][j];
+					if (std::max(first_column, i) < last_column)
+						segment(i, std::max(first_column, i), last_column, worker);
 				}
+			}
+		};
+	};
 
-				if (temporal_matrix[i][j] > temp_max && i != 0 && j != 0)
-				{
-					temp_max = temporal_matrix[i][j];
-				}
+	//coordinates, time windows and service times as structure of arrays, used by the batch kernels
+	std::vector<double> x(this->size), y(this->size), ready(this->size), due(this->size), service(this->size);
+	for (auto i = 0; i < this->size; i++)
+	{
+		x[i] = this->node->coord[i][0];
+		y[i] = this->node->coord[i][1];
+		ready[i] = this->node->time_window[i][0];
+		due[i] = this->node->time_window[i][1];
+		service[i] = this->node->service_time[i];
+	}
+	temporal_parameters parameters = { this->k1, this->k2, this->k3, this->max_width };
+
+	//travel (spatial) and temporal distances of a segment, travel points to the stored row or to travel_values
+	auto segment_distances = [&](int i, int begin, int end, double* travel_values, double* temporal)
+	{
+		const double* travel = travel_values;
+		if (exact)
+			travel = std::as_const(this->spatial_matrix.get_double()).upper_row(i) + (begin - i);
+		else
+			euclidean_row(x.data(), y.data(), i, begin, end, travel_values, nullptr);
+
+		//the distance is not unidirectional and the paper indicates the max as the right candidate, but results corrispond taking the min.
+		temporal_row(ready.data(), due.data(), service.data(), travel, i, begin, end, parameters, temporal);
+		return travel;
+	};
+
+	std::vector<bounds> found(worker_count(), initial);
+
+	//temporal matrix together with min and max of both spatial and temporal distances
+	parallel_for(tile_rows, for_each_tile([this, exact, &found, &segment_distances](int i, int begin, int end, int worker)
+	{
+		double travel_values[tile_size], temporal[tile_size];
+		auto travel = segment_distances(i, begin, end, travel_values, temporal);
+
+		auto& bound = found[worker];
+		for (auto j = begin; j < end; j++)
+		{
+			if (i == j)
+			{
+				//main diagonal is 0 (there is no distance if client[i] = client[j])
+				if (exact)
+					this->temporal_matrix.set(i, j, 0.0);
+				continue;
 			}
-			//main diagonal is 0 (there is no distance if client[i] = client[j])
-			else
+
+			if (exact)
+				this->temporal_matrix.set_symmetric(i, j, temporal[j - begin]);
+
+			//excluding depot from best min and max candidates
+			if (i != 0)
 			{
-				this->temporal_matrix[i][j] = 0.0;
+				if (travel[j - begin] > bound.max_distance)
+					bound.max_distance = travel[j - begin];
+				if (travel[j - begin] < bound.min_distance)
+					bound.min_distance = travel[j - begin];
+				if (temporal[j - begin] < bound.min_time)
+					bound.min_time = temporal[j - begin];
+				if (temporal[j - begin] > bound.max_time)
+					bound.max_time = temporal[j - begin];
 			}
+
+			bound.min_all_distance = std::min(bound.min_all_distance, travel[j - begin]);
+			bound.max_all_distance = std::max(bound.max_all_distance, travel[j - begin]);
+			bound.min_all_time = std::min(bound.min_all_time, temporal[j - begin]);
+			bound.max_all_time = std::max(bound.max_all_time, temporal[j - begin]);
 		}
+	}));
+
+	//reduction of the candidates found by every thread
+	auto result = initial;
+	for (auto& bound : found)
+	{
+		if (bound.max_distance > result.max_distance)
+			result.max_distance = bound.max_distance;
+		if (bound.min_distance < result.min_distance)
+			result.min_distance = bound.min_distance;
+		if (bound.min_time < result.min_time)
+			result.min_time = bound.min_time;
+		if (bound.max_time > result.max_time)
+			result.max_time = bound.max_time;
+
+		result.min_all_distance = std::min(result.min_all_distance, bound.min_all_distance);
+		result.max_all_distance = std::max(result.max_all_distance, bound.max_all_distance);
+		result.min_all_time = std::min(result.min_all_time, bound.min_all_time);
+		result.max_all_time = std::max(result.max_all_time, bound.max_all_time);
 	}
-	this->max_time = temp_max;
-	this->min_time = temp_min;
 
-	this->spatio_temporal_matrix.resize(this->size);
+	this->max_distance = result.max_distance;
+	this->min_distance = result.min_distance;
+	this->max_time = result.max_time;
+	this->min_time = result.min_time;
 
+	//spatiotemoral distance as sum of scaled and weighted spatial and temporal distance
+	auto spatio_temporal = [this](double spatial, double temporal)
+	{
+		return this->alpha1 * (spatial - this->min_distance) / (this->max_distance - this->min_distance) +
+			this->alpha2 * (temporal - this->min_time) / (this->max_time - this->min_time);
+	};
 
-	for (auto i = 0; i < this->size; i++)
+	if (exact)
 	{
-		spatio_temporal_matrix[i].resize(this->size);
+		this->spatio_temporal_matrix.resize(this->size, layout, precision);
+	}
+	else
+	{
+		//the spatiotemporal distance grows with both spatial and temporal distance, its range comes from theirs. The main diagonal is 0
+		this->temporal_matrix.resize(this->size, layout, precision, std::min(result.min_all_time, 0.0), std::max(result.max_all_time, 0.0));
+		this->spatio_temporal_matrix.resize(this->size, layout, precision,
+			std::min(spatio_temporal(result.min_all_distance, result.min_all_time), 0.0),
+			std::max(spatio_temporal(result.max_all_distance, result.max_all_time), 0.0));
+	}
+
+	parallel_for(tile_rows, for_each_tile([this, exact, &segment_distances, &spatio_temporal](int i, int begin, int end, int worker)
+	{
+		if (exact)
+		{
+			for (auto j = begin; j < end; j++)
+			{
+				if (i != j)
+					this->spatio_temporal_matrix.set_symmetric(i, j, spatio_temporal(this->spatial_matrix.get(i, j), this->temporal_matrix.get(i, j)));
+				else
+					this->spatio_temporal_matrix.set(i, j, 0);
+			}
+			return;
+		}
 
-		for (auto j = 0; j < this->size; j++)
+		double travel_values[tile_size], temporal[tile_size];
+		auto travel = segment_distances(i, begin, end, travel_values, temporal);
+
+		for (auto j = begin; j < end; j++)
 		{
 			if (i != j)
 			{
-				//spatiotemoral distance as sum of scaled and weighted spatial and temporal distance
-				this->spatio_temporal_matrix[i][j] =
-					this->alpha1 * (this->spatial_matrix[i][j] - this->min_distance) / (this->max_distance - this->min_distance) +
-					this->alpha2 * (this->temporal_matrix[i][j] - this->min_time) / (this->max_time - this->min_time);
+				this->temporal_matrix.set_symmetric(i, j, temporal[j - begin]);
+				this->spatio_temporal_matrix.set_symmetric(i, j, spatio_temporal(travel[j - begin], temporal[j - begin]));
 			}
-			
 			else
 			{
-				this->spatio_temporal_matrix[i][j] = 0;
+				this->temporal_matrix.set(i, j, 0.0);
+				this->spatio_temporal_matrix.set(i, j, 0);
 			}
 		}
-	}
+	}));
 }
 
 double SpatioTemporal::temporal_distance(int from_id, int to_id)
 {
 	//arrival time_window
 	double marked_tw_from[2];
-	auto tw_offset = double(this->node.service_time[from_id]) + this->spatial_matrix[from_id][to_id];
+	auto tw_offset = double(this->node->service_time[from_id]) + this->euclidean_distance(from_id, to_id);
 
 	/*arrival time_window considering client[from_id] service time and time_window plus travel time to client[to_id]
 	 if [a;b] is client[from_id] time_window then [a';b'] is the arrival time_window where  
 	 a' = a + service_time[from_id] + travel_time[from_id][to_id]
 	 b' = b + service_time[from_id] + travel_time[from_id][to_id]
 	 */
-	marked_tw_from[0] = double(this->node.time_window[from_id][0]) + tw_offset;
-	marked_tw_from[1] = double(this->node.time_window[from_id][1]) + tw_offset;
+	marked_tw_from[0] = double(this->node->time_window[from_id][0]) + tw_offset;
+	marked_tw_from[1] = double(this->node->time_window[from_id][1]) + tw_offset;
 
 	//client[to_id] real time window 
 	double tw_to[2];
-	tw_to[0] = double(this->node.time_window[to_id][0]);
-	tw_to[1] = double(this->node.time_window[to_id][1]);
+	tw_to[0] = double(this->node->time_window[to_id][0]);
+	tw_to[1] = double(this->node->time_window[to_id][1]);
 
 	//arrival to the next client could be early, good or late
 
@@ -209,15 +409,41 @@ double SpatioTemporal::temporal_distance(int from_id, int to_id)
 
 double SpatioTemporal::get_distance(int from_id, int to_id)
 {
-	return this->spatio_temporal_matrix[from_id][to_id];
+	return this->distance(from_id, to_id);
+}
+
+const PrecisionMatrix& SpatioTemporal::get_spatio_temporal_matrix() const
+{
+	return this->spatio_temporal_matrix;
 }
 
 double SpatioTemporal::get_spatial_distance(int from_id, int to_id)
 {
-	return this->spatial_matrix[from_id][to_id];
+	return this->spatial_matrix.get(from_id, to_id);
 }
 
 double SpatioTemporal::get_temporal_distance(int from_id, int to_id)
 {
-	return this->temporal_matrix[from_id][to_id];
+	return this->temporal_matrix.get(from_id, to_id);
+}
+
+void SpatioTemporal::add_to_snapshot(snapshot_matrices& matrices)
+{
+	Spatial::add_to_snapshot(matrices);
+
+	//snapshots store only double matrices
+	if (this->spatio_temporal_matrix.get_precision() != matrix_precision::f64)
+		return;
+
+	matrices.temporal = &this->temporal_matrix.get_double();
+	matrices.spatio_temporal = &this->spatio_temporal_matrix.get_double();
+	matrices.parameters[0] = this->k1;
+	matrices.parameters[1] = this->k2;
+	matrices.parameters[2] = this->k3;
+	matrices.parameters[3] = this->alpha1;
+}
+
+std::size_t SpatioTemporal::get_memory()
+{
+	return Spatial::get_memory() + this->temporal_matrix.bytes() + this->spatio_temporal_matrix.bytes();
 }
\ No newline at end of file
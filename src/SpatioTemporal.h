@@ -8,7 +8,7 @@
 * 
 */
 
-class SpatioTemporal : public Spatial
+class SpatioTemporal final : public Spatial
 {
 public:
 
@@ -16,18 +16,22 @@ public:
 	* constructor from file
 	* input
 	* file: file name as "name.extension"
+	* layout: storage of the matrices, packed needs half of the memory
+	* precision: type of the stored distances, f32 and u16 need less memory but round the distances
 	*
 	*/
-	SpatioTemporal(std::string file);
+	SpatioTemporal(std::string file, matrix_layout layout = matrix_layout::full, matrix_precision precision = matrix_precision::f64);
 
 	/**
 	* constructor from struct nodes
 	*
 	* input
 	* node: reference to an existing struct nodes
+	* layout: storage of the matrices, packed needs half of the memory
+	* precision: type of the stored distances, f32 and u16 need less memory but round the distances
 	*
 	*/
-	SpatioTemporal(nodes &node);
+	SpatioTemporal(nodes &node, matrix_layout layout = matrix_layout::full, matrix_precision precision = matrix_precision::f64);
 
 	/**
 	* constructors that change the default parameters
@@ -39,10 +43,35 @@ public:
 	* k3: multiplier in case of late arrival, the customer can not be served. The penalty rate should be higher then k2
 	* alpha1: multiplier associated with the spatial_distance, total distance is alpha1 * spatial_distance + alpha2 * temporal_distance
 	*		  alpha1 + alpha2 should be 1. If alpha1 > alpha2 means that spatial_distance is more important in total_distance
+	* layout: storage of the matrices, packed needs half of the memory
+	* precision: type of the stored distances
 	* 
 	*/
-	SpatioTemporal(nodes &node, double k1, double k2, double k3, double alpha1);
-	SpatioTemporal(std::string file, double k1, double k2, double k3, double alpha1);
+	SpatioTemporal(nodes &node, double k1, double k2, double k3, double alpha1, matrix_layout layout = matrix_layout::full, matrix_precision precision = matrix_precision::f64);
+	SpatioTemporal(std::string file, double k1, double k2, double k3, double alpha1, matrix_layout layout = matrix_layout::full, matrix_precision precision = matrix_precision::f64);
+
+	/**
+	* constructors from a shared instance, the spatial matrix is borrowed from it (see Spatial)
+	*
+	* input
+	* instance: instance shared with other objects
+	* k1, k2, k3, alpha1: same as above
+	* precision: type of the stored distances
+	*
+	*/
+	SpatioTemporal(std::shared_ptr<const Instance> instance, matrix_precision precision = matrix_precision::f64);
+	SpatioTemporal(std::shared_ptr<const Instance> instance, double k1, double k2, double k3, double alpha1, matrix_precision precision = matrix_precision::f64);
+
+	/**
+	* constructors from snapshot. Stored matrices are used without copies if they have been computed with the same parameters
+	*
+	* input:
+	* snapshot: reference to an opened NodesSnapshot
+	* k1, k2, k3, alpha1: same as above
+	*
+	*/
+	SpatioTemporal(NodesSnapshot& snapshot);
+	SpatioTemporal(NodesSnapshot& snapshot, double k1, double k2, double k3, double alpha1);
 
 	/**
 	* ovverides Spatial's get_distance function
@@ -57,6 +86,15 @@ public:
 	*/
 	double get_distance(int from_id, int to_id) override;
 
+	//non virtual version of get_distance, hides Spatial::distance
+	double distance(int from_id, int to_id) const
+	{
+		return this->spatio_temporal_matrix.get(from_id, to_id);
+	}
+
+	//stored spatiotemporal distances (see Spatial::get_spatial_matrix)
+	const PrecisionMatrix& get_spatio_temporal_matrix() const;
+
 	/**
 	* Spatial's get_distance funtion
 	* 
@@ -83,8 +121,24 @@ public:
 	*/
 	double get_temporal_distance(int from_id, int to_id);
 
+	//adds spatial, temporal and spatiotemporal matrices together with the parameters used to compute them, only if stored as double
+	void add_to_snapshot(snapshot_matrices& matrices) override;
+
+	std::size_t get_memory() override;
+
 private:
+	//reads spatial and temporal matrices together with their scaling bounds
+	friend class AlphaView;
+
 	void init();
+	void init(NodesSnapshot& snapshot);
+
+	//max time window width, needed by temporal_distance
+	void find_max_width();
+
+	//min and max spatial and temporal distances of the stored matrices
+	void find_bounds();
+	void set_parameters(double k1, double k2, double k3, double alpha1);
 	double temporal_distance(int from, int to);
 	double k1 = 1.0, k2 = 1.5, k3 = 2.0;
 	double alpha1 = 0.5, alpha2 = 1.0 - alpha1;
@@ -101,8 +155,8 @@ private:
 	double max_width = 0;
 
 	//square matrix containing the temporal distances between all pairs of customers
-	std::vector<std::vector<double>> temporal_matrix;
+	PrecisionMatrix temporal_matrix;
 
 	//square matrix containing the spatiotemporal distances between all pairs of customers
-	std::vector<std::vector<double>> spatio_temporal_matrix;
+	PrecisionMatrix spatio_temporal_matrix;
 };
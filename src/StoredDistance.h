@@ -0,0 +1,119 @@
+#pragma once
+#include "NodesDistance.h"
+#include "PrecisionMatrix.h"
+
+/**
+* size and neighbour lists of the NodesDistance whose matrices are read by a distance policy
+* (see StoredDistance, FusedDistance and DistancePolicy.h)
+*
+*/
+class NeighbourAccess
+{
+public:
+	explicit NeighbourAccess(NodesDistance& owner) : owner(&owner), size(owner.get_size())
+	{
+	}
+
+	int get_size() const
+	{
+		return this->size;
+	}
+
+	bool has_neighbours() const
+	{
+		return this->owner->has_neighbours();
+	}
+
+	int neighbour_count(int customer) const
+	{
+		return this->owner->neighbour_count(customer);
+	}
+
+	const int* neighbours(int customer) const
+	{
+		return this->owner->neighbours(customer);
+	}
+
+	const double* neighbour_distances(int customer) const
+	{
+		return this->owner->neighbour_distances(customer);
+	}
+
+private:
+	NodesDistance* owner;
+	int size;
+};
+
+/**
+* distance policy over a stored PrecisionMatrix whose precision is known at compile time.
+* Spatial, SpatioTemporal and Spatial3d are visited as StoredDistance (see visit_distance), so their
+* inner loops read the matrix without checking its precision at every distance
+*
+*/
+template<class T>
+class StoredDistance : public NeighbourAccess
+{
+public:
+	/**
+	* constructor
+	*
+	* input:
+	* owner: distance that owns the matrix, gives size and neighbour lists
+	* values: values of the matrix, must outlive this object
+	*
+	*/
+	StoredDistance(NodesDistance& owner, const TypedMatrix<T>& values) : NeighbourAccess(owner), values(values)
+	{
+	}
+
+	double distance(int from_id, int to_id) const
+	{
+		return this->values.get(from_id, to_id);
+	}
+
+private:
+	TypedMatrix<T> values;
+};
+
+/**
+* distance policy of an AlphaView that is not materialized: spatial and temporal values of the source, stored as T,
+* are scaled and combined with the alpha of the view by the same expression of SpatioTemporal
+*
+*/
+template<class T>
+class FusedDistance : public NeighbourAccess
+{
+public:
+	/**
+	* constructor
+	*
+	* input:
+	* owner: the AlphaView, gives size and neighbour lists
+	* spatial, temporal: values of the matrices of the source, must outlive this object
+	* alpha1, alpha2: multipliers of spatial and temporal distance
+	* min_distance, max_distance, min_time, max_time: scaling bounds of the source
+	*
+	*/
+	FusedDistance(NodesDistance& owner, const TypedMatrix<T>& spatial, const TypedMatrix<T>& temporal, double alpha1, double alpha2,
+		double min_distance, double max_distance, double min_time, double max_time) :
+		NeighbourAccess(owner), spatial(spatial), temporal(temporal), alpha1(alpha1), alpha2(alpha2),
+		min_distance(min_distance), max_distance(max_distance), min_time(min_time), max_time(max_time)
+	{
+	}
+
+	double distance(int from_id, int to_id) const
+	{
+		if (from_id == to_id)
+			return 0.0;
+
+		return this->alpha1 * (this->spatial.get(from_id, to_id) - this->min_distance) / (this->max_distance - this->min_distance) +
+			this->alpha2 * (this->temporal.get(from_id, to_id) - this->min_time) / (this->max_time - this->min_time);
+	}
+
+private:
+	TypedMatrix<T> spatial;
+	TypedMatrix<T> temporal;
+	double alpha1, alpha2;
+	double min_distance, max_distance;
+	double min_time, max_time;
+};
@@ -0,0 +1,97 @@
+#include "SubInstance.h"
+
+SubInstance::SubInstance(const nodes& node)
+{
+	this->parent = &node;
+	this->vehicles = node.vehicles;
+
+	auto size = node.id.size();
+	this->positions.resize(size);
+	for (int i = 0; i < size; i++)
+	{
+		this->positions[i] = i;
+	}
+}
+
+SubInstance::SubInstance(const nodes& node, const std::vector<int>& sub_id)
+{
+	this->parent = &node;
+	this->vehicles = node.vehicles;
+
+	//the depot is in 0, as in the parent
+	this->positions.reserve(sub_id.size() + 1);
+	this->positions.push_back(0);
+	this->positions.insert(this->positions.end(), sub_id.begin(), sub_id.end());
+}
+
+SubInstance::SubInstance(const SubInstance& view, const std::vector<int>& sub_id)
+{
+	this->parent = view.parent;
+	this->vehicles = view.vehicles;
+
+	this->positions.reserve(sub_id.size() + 1);
+	this->positions.push_back(view.positions[0]);
+	for (int i = 0; i < sub_id.size(); i++)
+	{
+		this->positions.push_back(view.positions[sub_id[i]]);
+	}
+}
+
+int SubInstance::get_vehicles() const
+{
+	return this->vehicles;
+}
+
+void SubInstance::set_vehicles(int vehicles)
+{
+	this->vehicles = vehicles;
+}
+
+int SubInstance::get_capacity() const
+{
+	return this->parent->capacity;
+}
+
+const nodes& SubInstance::get_parent() const
+{
+	return *this->parent;
+}
+
+void SubInstance::copy_nodes(nodes& sub_nodes) const
+{
+	auto size = this->positions.size();
+
+	sub_nodes.vehicles = this->vehicles;
+	sub_nodes.capacity = this->parent->capacity;
+
+	sub_nodes.id.resize(size);
+	sub_nodes.coord.resize(size);
+	sub_nodes.time_window.resize(size);
+	sub_nodes.demand.resize(size);
+	sub_nodes.service_time.resize(size);
+
+	for (int i = 0; i < size; i++)
+	{
+		sub_nodes.id[i] = this->id(i);
+		sub_nodes.coord[i] = this->coord(i);
+		sub_nodes.time_window[i] = this->time_window(i);
+		sub_nodes.demand[i] = this->demand(i);
+		sub_nodes.service_time[i] = this->service_time(i);
+	}
+}
+
+void SubInstance::copy_time_matrix(const std::vector<std::vector<int>>& time_matrix, std::vector<std::vector<int>>& sub_matrix) const
+{
+	auto size = this->positions.size();
+	sub_matrix.assign(size, std::vector<int>(size));
+
+	//one source row per customer, with customers renumbered along a curve (see CurveOrder) the positions are a few runs of near ids
+	for (int i = 0; i < size; i++)
+	{
+		auto& row = time_matrix[this->positions[i]];
+		for (int j = 0; j < size; j++)
+		{
+			sub_matrix[i][j] = row[this->positions[j]];
+		}
+	}
+}
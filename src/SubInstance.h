@@ -0,0 +1,113 @@
+#pragma once
+#include "NodesDistance.h"
+#include <array>
+#include <vector>
+
+/**
+* sub-problem made of the depot and a group of customers of an instance, without copies of the instance data
+*
+* position i of the sub-problem (the depot is always in 0) is position(i) in the columns and in the travel times
+* of the parent, the index list is the only allocation. Used in place of init_sub_nodes (which copies five columns
+* and, in OrTools, a square matrix for each cluster) by OrTools::solve_sub_problem and Voronoi.
+* The parent must outlive the view and must not be modified meanwhile
+*
+*/
+class SubInstance
+{
+public:
+	/**
+	* view over the whole instance
+	*
+	* input:
+	* node: reference to the parent struct nodes
+	*
+	*/
+	SubInstance(const nodes& node);
+
+	/**
+	* view over the depot and a group of customers
+	*
+	* input:
+	* node: reference to the parent struct nodes
+	* sub_id: positions in node of the customers of the sub-problem, depot excluded (as in init_sub_nodes)
+	*
+	*/
+	SubInstance(const nodes& node, const std::vector<int>& sub_id);
+
+	/**
+	* view over a group of customers of another view (e.g. a cluster split again), the parent is the same
+	*
+	* input:
+	* view: reference to the view that contains the customers
+	* sub_id: positions in view of the customers of the sub-problem, depot excluded
+	*
+	*/
+	SubInstance(const SubInstance& view, const std::vector<int>& sub_id);
+
+	//number of customers of the sub-problem, depot included
+	int get_size() const
+	{
+		return int(this->positions.size());
+	}
+
+	//position of customer i in the columns and in the matrices of the parent
+	int position(int i) const
+	{
+		return this->positions[i];
+	}
+
+	//id of customer i in the parent, the same of sub_nodes.id[i] after init_sub_nodes
+	int id(int i) const
+	{
+		return this->parent->id[this->positions[i]];
+	}
+
+	const std::array<int, 2>& coord(int i) const
+	{
+		return this->parent->coord[this->positions[i]];
+	}
+
+	const std::array<int, 2>& time_window(int i) const
+	{
+		return this->parent->time_window[this->positions[i]];
+	}
+
+	int demand(int i) const
+	{
+		return this->parent->demand[this->positions[i]];
+	}
+
+	int service_time(int i) const
+	{
+		return this->parent->service_time[this->positions[i]];
+	}
+
+	//vehicles available for the sub-problem, the ones of the parent if not set
+	int get_vehicles() const;
+	void set_vehicles(int vehicles);
+
+	int get_capacity() const;
+
+	const nodes& get_parent() const;
+
+	/**
+	* copies of the viewed data, for the code that needs an owned struct nodes or a square matrix
+	*
+	* input:
+	* sub_nodes: reference to the to be initialized structure, same result of init_sub_nodes
+	*  or
+	* time_matrix: square matrix of travel times between the customers of the parent
+	* sub_matrix: reference to the to be initialized matrix, travel times between the customers of the view
+	*
+	*/
+	void copy_nodes(nodes& sub_nodes) const;
+	void copy_time_matrix(const std::vector<std::vector<int>>& time_matrix, std::vector<std::vector<int>>& sub_matrix) const;
+
+private:
+	const nodes* parent;
+
+	//positions in the parent, the first one is the depot
+	std::vector<int> positions;
+
+	int vehicles = 0;
+};
@@ -0,0 +1,79 @@
+#include "ThreadPool.h"
+#include "ParallelFor.h"
+
+ThreadPool::ThreadPool(int workers)
+{
+	if (workers <= 0)
+		workers = worker_count();
+
+	for (auto worker = 1; worker < workers; worker++)
+		this->threads.emplace_back(&ThreadPool::work, this, worker);
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->stop = true;
+	}
+	this->start.notify_all();
+
+	for (auto& thread : this->threads)
+		thread.join();
+}
+
+void ThreadPool::run(int tasks, const std::function<void(int, int)>& function)
+{
+	//nothing to share, the calling thread does everything
+	if (this->threads.empty() || tasks <= 1)
+	{
+		for (auto task = 0; task < tasks; task++)
+			function(task, 0);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->function = &function;
+		this->tasks = tasks;
+		this->next = 0;
+		this->active = int(this->threads.size());
+		this->round++;
+	}
+	this->start.notify_all();
+
+	for (auto task = this->next++; task < tasks; task = this->next++)
+		function(task, 0);
+
+	std::unique_lock<std::mutex> lock(this->mutex);
+	this->done.wait(lock, [this] { return this->active == 0; });
+	this->function = nullptr;
+}
+
+int ThreadPool::get_workers() const
+{
+	return int(this->threads.size()) + 1;
+}
+
+void ThreadPool::work(int worker)
+{
+	long long seen = 0;
+
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(this->mutex);
+			this->start.wait(lock, [this, seen] { return this->stop || this->round != seen; });
+			if (this->stop)
+				return;
+			seen = this->round;
+		}
+
+		for (auto task = this->next++; task < this->tasks; task = this->next++)
+			(*this->function)(task, worker);
+
+		std::lock_guard<std::mutex> lock(this->mutex);
+		if (--this->active == 0)
+			this->done.notify_one();
+	}
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+* fixed set of threads that run many batches of tasks, as parallel_for but without starting and joining
+* threads at every call (e.g. once per generation of GeneticEvolution).
+* Only one batch at a time can run, tasks must not call run of the same pool
+*
+*/
+class ThreadPool
+{
+public:
+	/**
+	* constructor, the calling thread of run is one of the workers
+	*
+	* input:
+	* workers: number of threads, 0 means worker_count() (see ParallelFor.h)
+	*
+	*/
+	ThreadPool(int workers = 0);
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	//waits for the threads to end
+	~ThreadPool();
+
+	/**
+	* runs function(task, worker) for every task in [0; tasks), tasks are handed out in increasing order to the first
+	* free worker. Returns when all tasks are done
+	*
+	* input:
+	* tasks: number of tasks
+	* function: callable as function(int task, int worker), worker is in [0; get_workers()) and
+	*			can be used to index per-thread data
+	*
+	*/
+	void run(int tasks, const std::function<void(int, int)>& function);
+
+	int get_workers() const;
+
+private:
+	void work(int worker);
+
+	std::vector<std::thread> threads;
+
+	std::mutex mutex;
+	std::condition_variable start;
+	std::condition_variable done;
+
+	//current batch, changed only while no thread is working
+	const std::function<void(int, int)>* function = nullptr;
+	int tasks = 0;
+	std::atomic<int> next{ 0 };
+
+	//number of batches started, threads still working on the current one
+	long long round = 0;
+	int active = 0;
+	bool stop = false;
+};
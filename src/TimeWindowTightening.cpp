@@ -0,0 +1,145 @@
+#include "TimeWindowTightening.h"
+#include <algorithm>
+#include <climits>
+
+/**
+* propagation rules of tighten_time_windows over windows stored as columns
+*
+* input:
+* ready, due: time windows, tightened in place (partially changed if the result is not feasible)
+* service: service times
+* travel: function that gives the travel time from customer i to customer j
+* max_rounds: maximum number of passes
+*
+* output:
+* summary of the changes, tightened and removed_width are not computed
+*
+*/
+template<class Travel>
+static tightening_result propagate(std::vector<long long>& ready, std::vector<long long>& due, const std::vector<long long>& service,
+	Travel travel, int max_rounds)
+{
+	tightening_result result;
+	int size = ready.size();
+
+	bool changed = true;
+	while (changed && result.rounds < max_rounds)
+	{
+		changed = false;
+		result.rounds++;
+
+		for (auto k = 1; k < size; k++)
+		{
+			//earliest arrival from any predecessor and latest departure towards any successor
+			auto earliest = LLONG_MAX;
+			auto latest = LLONG_MIN;
+			for (auto i = 0; i < size; i++)
+			{
+				if (i == k)
+					continue;
+
+				earliest = std::min(earliest, ready[i] + service[i] + travel(i, k));
+				latest = std::max(latest, due[i] - service[k] - travel(k, i));
+			}
+
+			//an empty window means that no route can serve the customer
+			auto new_ready = std::max(ready[k], earliest);
+			auto new_due = std::min(due[k], latest);
+			if (new_due < new_ready)
+			{
+				result.feasible = false;
+				return result;
+			}
+
+			if (new_ready != ready[k] || new_due != due[k])
+			{
+				ready[k] = new_ready;
+				due[k] = new_due;
+				changed = true;
+			}
+		}
+	}
+
+	return result;
+}
+
+//customers that lost part of their window and total width removed
+static void count_removed(const std::vector<long long>& old_ready, const std::vector<long long>& old_due,
+	const std::vector<long long>& ready, const std::vector<long long>& due, tightening_result& result)
+{
+	for (std::size_t i = 1; i < ready.size(); i++)
+	{
+		auto removed = (old_due[i] - old_ready[i]) - (due[i] - ready[i]);
+		if (removed > 0)
+		{
+			result.tightened++;
+			result.removed_width += removed;
+		}
+	}
+}
+
+tightening_result tighten_time_windows(nodes& node, const std::vector<std::vector<int>>& time_matrix, int max_rounds)
+{
+	int size = node.id.size();
+	if (size < 2)
+		return tightening_result();
+
+	//int64 values, sums of times and due dates can not overflow
+	std::vector<long long> ready(size), due(size), service(size);
+	for (auto i = 0; i < size; i++)
+	{
+		ready[i] = node.time_window[i][0];
+		due[i] = node.time_window[i][1];
+		service[i] = node.service_time[i];
+	}
+	auto old_ready = ready;
+	auto old_due = due;
+
+	auto result = propagate(ready, due, service, [&time_matrix](int i, int j)
+	{
+		return time_matrix[i][j];
+	}, max_rounds);
+	if (!result.feasible)
+		return result;
+
+	count_removed(old_ready, old_due, ready, due, result);
+	for (auto i = 1; i < size; i++)
+	{
+		node.time_window[i][0] = int(ready[i]);
+		node.time_window[i][1] = int(due[i]);
+	}
+
+	return result;
+}
+
+tightening_result tighten_time_windows(const SubInstance& node, const DistanceMatrix<int>& time_matrix,
+	std::vector<long long>& ready, std::vector<long long>& due, int max_rounds)
+{
+	int size = node.get_size();
+	std::vector<long long> service(size);
+	ready.resize(size);
+	due.resize(size);
+	for (auto i = 0; i < size; i++)
+	{
+		ready[i] = node.time_window(i)[0];
+		due[i] = node.time_window(i)[1];
+		service[i] = node.service_time(i);
+	}
+	if (size < 2)
+		return tightening_result();
+
+	auto new_ready = ready;
+	auto new_due = due;
+	auto result = propagate(new_ready, new_due, service, [&node, &time_matrix](int i, int j)
+	{
+		return time_matrix.get(node.position(i), node.position(j));
+	}, max_rounds);
+	if (!result.feasible)
+		return result;
+
+	count_removed(ready, due, new_ready, new_due, result);
+	ready.swap(new_ready);
+	due.swap(new_due);
+
+	return result;
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include "NodesDistance.h"
+#include "SubInstance.h"
+#include "DistanceMatrix.h"
+#include <vector>
+
+/**
+* summary of tighten_time_windows
+*
+* rounds: number of passes over all the customers, the last one changes nothing
+* tightened: number of customers whose time window has been reduced
+* removed_width: sum of the widths cut from the time windows
+* feasible: false if some time window became empty, in that case the windows are not changed
+*
+*/
+struct tightening_result
+{
+	int rounds = 0;
+	int tightened = 0;
+	long long removed_width = 0;
+	bool feasible = true;
+};
+
+/**
+* tightens ready and due times of the customers with the standard propagation rules, until nothing changes.
+* Service starts when the vehicle arrives, travel from i to j takes time_matrix[i][j] + service(i) as in OrTools
+* and every route ends at the depot by its due date:
+*	ready(k) >= min over predecessors i (depot included) of ready(i) + service(i) + time(i, k)
+*	due(k) <= max over successors j (depot included) of due(j) - service(k) - time(k, j)
+* Each rule only removes times that no route can use, the depot window is not changed
+*
+* input:
+* node: reference to the structure whose time windows are tightened
+* time_matrix: square matrix of travel times between customers
+* max_rounds: maximum number of passes
+*
+* output:
+* summary of the changes
+*
+*/
+tightening_result tighten_time_windows(nodes& node, const std::vector<std::vector<int>>& time_matrix, int max_rounds = 50);
+
+/**
+* same rules over the customers of a SubInstance, travel times read from the matrix of the parent through the positions
+* of the view. The view is not changed, the windows are written in ready and due, one value for each position of the view
+* (the original ones if the result is not feasible)
+*
+* input:
+* node: reference to the view over the sub-problem
+* time_matrix: square matrix (full layout) of travel times between the customers of the parent
+* ready, due: references to the to be initialized windows
+* max_rounds: maximum number of passes
+*
+* output:
+* summary of the changes
+*
+*/
+tightening_result tighten_time_windows(const SubInstance& node, const DistanceMatrix<int>& time_matrix,
+	std::vector<long long>& ready, std::vector<long long>& due, int max_rounds = 50);
@@ -2,6 +2,8 @@
 #include "Spatial.h"
 #include "SpatioTemporal.h"
 #include "ConsecutiveRandoms.h"
+#include "DistancePolicy.h"
+#include "Instance.h"
 #include <libqhullcpp/RboxPoints.h>
 #include <libqhullcpp/QhullError.h>
 #include <libqhullcpp/QhullQh.h>
@@ -34,26 +36,34 @@ using orgQhull::QhullRidgeSet;
 using orgQhull::QhullRidgeSetIterator;
 
 
-Voronoi::Voronoi(nodes& node, NodesDistance& distance, bool use_balance)
+Voronoi::Voronoi(std::shared_ptr<const Instance> instance, NodesDistance& distance, bool use_balance) : Voronoi(instance->get_nodes(), distance, use_balance)
+{
+    this->instance = instance;
+}
+
+Voronoi::Voronoi(const nodes& node, NodesDistance& distance, bool use_balance) : Voronoi(SubInstance(node), distance, use_balance)
+{
+}
+
+Voronoi::Voronoi(const SubInstance& view, NodesDistance& distance, bool use_balance) : view(view)
 {
-	this->node = &node;
 	this->distance = &distance;
     this->balanced = use_balance;
 
     std::string points_3d("");
 
     //append all points in a string
-    for (int i = 0; i < this->node->id.size(); i++)
+    for (int i = 0; i < this->view.get_size(); i++)
     {
-        points_3d += std::to_string(this->node->coord[i][0]) + " " + std::to_string(this->node->coord[i][1]) + " ";
-        double half = (this->node->time_window[i][0] + this->node->time_window[i][1]) / 2.0;
+        points_3d += std::to_string(this->view.coord(i)[0]) + " " + std::to_string(this->view.coord(i)[1]) + " ";
+        double half = (this->view.time_window(i)[0] + this->view.time_window(i)[1]) / 2.0;
         points_3d += std::to_string(half) + " ";
     }
 
     RboxPoints rbox;
 
     //contains: number of dimension (3d points), number of points, points 3d coord
-    std::istringstream is(("3 " + std::to_string(this->node->id.size()) + " " + points_3d));
+    std::istringstream is(("3 " + std::to_string(this->view.get_size()) + " " + points_3d));
 
     //initialize rbox and qhull and compute Voronoi diagram
     rbox.appendPoints(is);
@@ -86,7 +96,7 @@ std::vector<std::vector<int>> Voronoi::voronoi_part(int n_part, int n_iter)
     {
         double temp_cost = 0;
 
-        ConsecutiveRandoms<int> rand(1, this->node->id.size() - 1);
+        ConsecutiveRandoms<int> rand(1, this->view.get_size() - 1);
 
         //generate n_part different seeds
         std::set<int> partition;
@@ -98,7 +108,7 @@ std::vector<std::vector<int>> Voronoi::voronoi_part(int n_part, int n_iter)
         std::vector<std::list<int>> queue(n_part, std::list<int>());
         std::vector<std::vector<int>>* groups = new std::vector<std::vector<int>>(n_part, std::vector<int>());
 
-        std::vector<bool> inserted(this->node->id.size(), false);
+        std::vector<bool> inserted(this->view.get_size(), false);
 
         //exclude depot from clusters
         inserted[0] = true;
@@ -107,7 +117,7 @@ std::vector<std::vector<int>> Voronoi::voronoi_part(int n_part, int n_iter)
         for (auto i = partition.begin(); i != partition.end(); i++)
         {
             queue[index].push_back(*i);
-            groups->at(index).push_back(this->node->id[*i]);
+            groups->at(index).push_back(this->view.id(*i));
             inserted[*i] = true;
             index++;
         }
@@ -137,7 +147,7 @@ std::vector<std::vector<int>> Voronoi::voronoi_part(int n_part, int n_iter)
         this->queue_left(*groups, inserted, assign_group, gravity);
 
         //when possible elements are added as in first phase, otherwise left noded are added to the nearer group
-        while (total_size < (this->node->id.size() - 1))
+        while (total_size < (this->view.get_size() - 1))
         {
 
             for (auto i = 0; i < n_part; i++)
@@ -149,8 +159,8 @@ std::vector<std::vector<int>> Voronoi::voronoi_part(int n_part, int n_iter)
                     if (!inserted[front])
                     {
                         queue[i].push_back(front);
-                        groups->at(i).push_back(this->node->id[front]);
-                        temp_cost += this->distance->get_distance(this->node->id[front], gravity[i]);
+                        groups->at(i).push_back(this->view.id(front));
+                        temp_cost += this->distance->get_distance(this->view.id(front), gravity[i]);
                         total_size++;
                         inserted[front] = true;
                     }
@@ -243,7 +253,20 @@ std::vector<std::vector<int>> Voronoi::voronoi_part_bubble(int n_part)
 
     }
     std::cout << solution_cost.first << " " << solution_cost.second <<" "<< this->max << std::endl;
-    return *groups;
+
+    //groups are built with positions in the view, the partition has the ids of the parent
+    std::vector<std::vector<int>> partition(groups->size());
+    for (auto i = 0; i < groups->size(); i++)
+    {
+        partition[i].reserve(groups->at(i).size());
+        for (auto position : groups->at(i))
+        {
+            partition[i].push_back(this->view.id(position));
+        }
+    }
+    delete groups;
+
+    return partition;
 }
 
 std::pair<int, double> Voronoi::strongest_partition(std::vector<int>& seed, std::vector<std::vector<int>>& group)
@@ -253,7 +276,7 @@ std::pair<int, double> Voronoi::strongest_partition(std::vector<int>& seed, std:
     auto compare = [](std::pair<int, double> a, std::pair<int, double> b) {return a.first != b.first && a.second <= b.second;};
     std::vector<std::set<std::pair<int, double>, decltype(compare)>> candidate(n_part, std::set<std::pair<int, double>, decltype(compare)>(compare));
 
-    std::vector<bool> inserted(this->node->id.size(), false);
+    std::vector<bool> inserted(this->view.get_size(), false);
   
     this->init_groups(inserted, seed, group, candidate);
     
@@ -306,26 +329,27 @@ std::pair<int, double> Voronoi::strongest_partition(std::vector<int>& seed, std:
         }
     }
 
-    for (auto i = 0; i < inserted.size(); i++)
+    //seeds and customers are positions in the view, distances are the ones of the parent
+    std::vector<int> seed_id(seed.size());
+    for (auto i = 0; i < seed.size(); i++)
     {
-        if (!inserted[i])
+        seed_id[i] = this->view.id(seed[i]);
+    }
+
+    visit_distance(*this->distance, [this, &inserted, &seed_id, &group, &cost](auto& distance)
+    {
+        for (auto i = 0; i < inserted.size(); i++)
         {
-            auto min = this->distance->get_distance(seed[0], i);
-            auto selected = 0;
-            for (auto j = 1; j < seed.size(); j++)
+            if (!inserted[i])
             {
-                auto temp_min = this->distance->get_distance(seed[j], i);
-                if (temp_min < min)
-                {
-                    min = temp_min;
-                    selected = j;
-                }
+                double min;
+                auto selected = nearest_medoid(distance, seed_id, this->view.id(i), min);
+                group[selected].push_back(i);
+                inserted[i] = true;
+                cost += min;
             }
-            group[selected].push_back(i);
-            inserted[i] = true;
-            cost += min;
         }
-    }
+    });
     
     int min_partition = group[0].size();
     int max_partition = min_partition;
@@ -349,7 +373,7 @@ std::pair<int, double> Voronoi::balanced_partition(std::vector<int>& seed, std::
     auto compare = [](std::pair<int, double> a, std::pair<int, double> b) {return a.first != b.first && a.second <= b.second;};
     std::vector<std::set<std::pair<int, double>, decltype(compare)>> candidate(n_part, std::set<std::pair<int, double>, decltype(compare)>(compare));
 
-    std::vector<bool> inserted(this->node->id.size(), false);
+    std::vector<bool> inserted(this->view.get_size(), false);
 
     this->init_groups(inserted, seed, group, candidate);
 
@@ -378,26 +402,27 @@ std::pair<int, double> Voronoi::balanced_partition(std::vector<int>& seed, std::
 
     } while (size > 0);
 
-    for (auto i = 0; i < inserted.size(); i++)
+    //seeds and customers are positions in the view, distances are the ones of the parent
+    std::vector<int> seed_id(seed.size());
+    for (auto i = 0; i < seed.size(); i++)
     {
-        if (!inserted[i])
+        seed_id[i] = this->view.id(seed[i]);
+    }
+
+    visit_distance(*this->distance, [this, &inserted, &seed_id, &group, &cost](auto& distance)
+    {
+        for (auto i = 0; i < inserted.size(); i++)
         {
-            auto min = this->distance->get_distance(seed[0], i);
-            auto selected = 0;
-            for (auto j = 1; j < seed.size(); j++)
+            if (!inserted[i])
             {
-                auto temp_min = this->distance->get_distance(seed[j], i);
-                if (temp_min < min)
-                {
-                    min = temp_min;
-                    selected = j;
-                }
+                double min;
+                auto selected = nearest_medoid(distance, seed_id, this->view.id(i), min);
+                group[selected].push_back(i);
+                inserted[i] = true;
+                cost += min;
             }
-            group[selected].push_back(i);
-            inserted[i] = true;
-            cost += min;
         }
-    }
+    });
 
     int min_partition = group[0].size();
     int max_partition = min_partition;
@@ -419,32 +444,35 @@ bool Voronoi::balance(std::vector<int>& seed, std::vector<std::vector<int>>& gro
     double cost = 0;
     bool changed = false;
 
-    for (auto i = 0; i < groups.size(); i++)
+    visit_distance(*this->distance, [this, &seed, &groups, &cost, &changed](auto& policy)
     {
-        //set actual seed distance from al group members
-        double distance = 0.0;
-        for (auto j = 0; j < groups[i].size(); j++)
-        {
-            distance += this->distance->get_distance(groups[i][0], groups[i][j]);
-        }
-
-        //search for better seed
-        for (auto j = 1; j < groups[i].size(); j++)
+        std::vector<int> member;
+        for (auto i = 0; i < groups.size(); i++)
         {
-            double temp_distance = 0.0;
-            for (auto k = 0; k < groups[i].size(); k++)
+            //groups have positions in the view, distances are computed between the ids of the parent
+            member.resize(groups[i].size());
+            for (auto j = 0; j < groups[i].size(); j++)
             {
-                temp_distance += this->distance->get_distance(groups[i][j], groups[i][k]);
+                member[j] = this->view.id(groups[i][j]);
             }
-            if (temp_distance < distance)
+
+            //set actual seed distance from al group members
+            double distance = group_distance(policy, member[0], member);
+
+            //search for better seed
+            for (auto j = 1; j < groups[i].size(); j++)
             {
-                distance = temp_distance;
-                seed[i] = groups[i][j];
-                changed = true;
+                double temp_distance = group_distance(policy, member[j], member);
+                if (temp_distance < distance)
+                {
+                    distance = temp_distance;
+                    seed[i] = groups[i][j];
+                    changed = true;
+                }
             }
+            cost += distance;
         }
-        cost += distance;
-    }
+    });
 
     return changed;
 }
@@ -504,7 +532,7 @@ double Voronoi::grow_cluster(int &total_size, std::vector<int>& group, std::vect
         {
             if (!inserted[*k])
             {
-                auto temp = this->distance->get_distance(this->node->id[head], this->node->id[*k]);
+                auto temp = this->distance->get_distance(this->view.id(head), this->view.id(*k));
 
                 if (!have_distance)
                 {
@@ -523,7 +551,7 @@ double Voronoi::grow_cluster(int &total_size, std::vector<int>& group, std::vect
         if (have_distance)
         {
             queue.push_back(node_id);
-            group.push_back(this->node->id[node_id]);
+            group.push_back(this->view.id(node_id));
             inserted[node_id] = true;
             total_size++;
         }
@@ -534,64 +562,49 @@ double Voronoi::grow_cluster(int &total_size, std::vector<int>& group, std::vect
 
 void Voronoi::queue_left(std::vector<std::vector<int>>& groups, std::vector<bool>& inserted, std::vector<std::list<int>>& assign_group, std::vector<int>& gravity)
 {
-    auto group_distance = [this](int customer_id, std::vector<int>& group)
-    {
-        double acc_distance = 0;
-        for (auto i = 0; i < group.size(); i++)
-        {
-            acc_distance += this->distance->get_distance(customer_id, group[i]);
-        }
-        return acc_distance;
-    };
-
-    //find gravity points of groups
     auto n_part = groups.size();
     gravity.reserve(n_part);
-    for (auto i = 0; i < n_part; i++)
-    {
-        int candidate = groups[i][0];
-        double actual_distance = group_distance(candidate, groups[i]);
-        for (int j = 1; j < groups[i].size(); j++)
-        {
-            auto temp_distance = group_distance(groups[i][j], groups[i]);
-            if (temp_distance < actual_distance)
-            {
-                actual_distance = temp_distance;
-                candidate = groups[i][j];
-            }
-        }
-        gravity.push_back(candidate);
-    }
 
     for (int i = 0; i < n_part; i++)
     {
         assign_group.push_back(std::list<int>());
     }
 
-    //assign each left element to one of the existing groups
-    for (auto i = 1; i < this->node->id.size(); i++)
+    visit_distance(*this->distance, [this, &groups, &inserted, &assign_group, &gravity, n_part](auto& distance)
     {
-        if (!inserted[i])
+        //find gravity points of groups
+        for (auto i = 0; i < n_part; i++)
         {
-            int group_id = 0;
-            double actual_group_distance = this->distance->get_distance(this->node->id[i], gravity[group_id]);
-            for (auto j = 1; j < n_part; j++)
+            int candidate = groups[i][0];
+            double actual_distance = group_distance(distance, candidate, groups[i]);
+            for (int j = 1; j < groups[i].size(); j++)
             {
-                auto temp_distance = this->distance->get_distance(this->node->id[i], gravity[j]);
-                if (temp_distance < actual_group_distance)
+                auto temp_distance = group_distance(distance, groups[i][j], groups[i]);
+                if (temp_distance < actual_distance)
                 {
-                    actual_group_distance = temp_distance;
-                    group_id = j;
+                    actual_distance = temp_distance;
+                    candidate = groups[i][j];
                 }
             }
-            assign_group[group_id].push_back(i);
+            gravity.push_back(candidate);
         }
-    }
+
+        //assign each left element to one of the existing groups, the distance is symmetric
+        for (auto i = 1; i < this->view.get_size(); i++)
+        {
+            if (!inserted[i])
+            {
+                double actual_group_distance;
+                auto group_id = nearest_medoid(distance, gravity, this->view.id(i), actual_group_distance);
+                assign_group[group_id].push_back(i);
+            }
+        }
+    });
 }
 
 std::vector<int> Voronoi::generate_seed(int n_part)
 {
-    ConsecutiveRandoms<int> rand(1, this->node->id.size() - 1);
+    ConsecutiveRandoms<int> rand(1, this->view.get_size() - 1);
 
     std::vector<int> seed;
     seed.reserve(n_part);
@@ -618,7 +631,7 @@ void Voronoi::update_candidate(std::vector<bool>& inserted, int customer, T& can
     {
         if (!inserted[neigh[i]])
         {
-            auto dist = this->distance->get_distance(customer, neigh[i]);
+            auto dist = this->distance->get_distance(this->view.id(customer), this->view.id(neigh[i]));
             auto add = candidate.insert(std::pair(neigh[i], dist));
             if (!add.second && add.first->second > dist)
             {
@@ -1,6 +1,7 @@
 #pragma once
 #include "NodesDistance.h"
 #include "SpatioTemporal.h"
+#include "SubInstance.h"
 #include <libqhullcpp/Qhull.h>
 #include <libqhullcpp/QhullVertex.h>
 #include<list>
@@ -23,7 +24,28 @@ public:
 	* distance: reference to an istance of NodeDistance, determines the distance used in the algorithm (Euclidean, spatiotemporal)
 	*
 	*/
-	Voronoi(nodes& node, NodesDistance& distance, bool use_balanced = true);
+	Voronoi(const nodes& node, NodesDistance& distance, bool use_balanced = true);
+
+	/**
+	* costructor from a shared instance, its nodes are borrowed and kept alive
+	*
+	* input:
+	* instance: instance shared with other objects
+	* distance, use_balanced: same as above
+	*
+	*/
+	Voronoi(std::shared_ptr<const Instance> instance, NodesDistance& distance, bool use_balanced = true);
+
+	/**
+	* costructor on a sub-problem, e.g. a cluster to split again, without copies of its customers.
+	* The groups contain the ids of the parent, distance must be the one of the parent
+	*
+	* input:
+	* view: view over the depot and the customers of the sub-problem
+	* distance, use_balanced: same as above
+	*
+	*/
+	Voronoi(const SubInstance& view, NodesDistance& distance, bool use_balanced = true);
 
 	/**
 	* function that makes a partition of the customers using a Voronoi diagram.
@@ -41,7 +63,11 @@ public:
 	std::vector<std::vector<int>> voronoi_part_bubble(int n_part);
 
 private:
-	nodes* node;
+	//customers to partition, the whole instance or a sub-problem
+	SubInstance view;
+
+	//owner of the nodes when built from an instance, nullptr otherwise
+	std::shared_ptr<const Instance> instance;
 	NodesDistance* distance;
 	bool balanced = true;
 	int max = 0;
@@ -61,6 +87,8 @@ private:
 
 	std::vector<int> find_neighbours(int id);
 	
+	//the functions of voronoi_part_bubble work with positions in the view (seeds, groups, candidates), the ids of the
+	//parent are used only for distances and for the returned partition
 	std::pair<int, double> strongest_partition(std::vector<int>& seed, std::vector<std::vector<int>>& group);
 	std::pair<int, double> balanced_partition(std::vector<int>& seed, std::vector<std::vector<int>>& group);
 